@@ -3,6 +3,7 @@
 // === Standard Library Includes ===
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <ctime>
 #include <deque>
 #include <iomanip>
@@ -11,32 +12,382 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <cstdint>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <fstream>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
 
 // === External Dependencies ===
 #include "json.hpp"
 using json = nlohmann::json;
 
-// === Edge Structure ===
-struct Edge {
-    int source;
-    int destination;
-    double weight;          // -log(price) for Bellman-Ford
-    double price;           // actual exchange rate
-    std::string exchange;   // "Binance", "OKX", "Cross"
-    std::string symbol;     // trading pair symbol
+// === Fixed-Point Log-Weights ===
+// -log(price) in units of 2^-TICK_BITS (about 1e-6, 50x finer than
+// log(PROFIT_MIN)), rounded to nearest once when a price is stored. Prices
+// are validated to 1e-8..1e8, so one edge is under 2^25 ticks and a walk of
+// up to TICK_MAX_HOPS edges sums without overflowing int32. Sums are exact,
+// so they do not depend on the order they were added in.
+constexpr int TICK_BITS = 20;
+constexpr int TICK_MAX_HOPS = 63;
+constexpr int32_t TICK_INF = INT32_MAX;     // unreached
+inline int32_t toTicks(double w)
+{
+    const double limit = 1 << 25;
+    return static_cast<int32_t>(std::lround(std::max(-limit, std::min(limit, std::ldexp(w, TICK_BITS)))));
+}
+
+// === Edge Storage (structure-of-arrays) ===
+// One record per market, as quoted (base -> quote at `price`). The quote ->
+// base side is never stored: a record owns an even run of edge ids starting
+// at firstEdge[r], where an even id runs from a peer to the quote and the
+// odd id after it back (inverse weight is the exact negation, inverse price
+// the reciprocal). A market has one peer, its base. A Cross bridge record
+// joins its quote to an asset's bridge group, and its peers are every node
+// that joined before, so each exchange pair keeps one direct bridge while
+// the group stores one record per node. Only the records are linear in the
+// number of exchanges: the edge id layout below, the CSR and the component
+// lists still hold both sides of every market and N(N-1) bridge arcs per
+// asset, because every relaxation loop walks explicit arcs. The relaxation
+// loops only read src/dst/weight, so those sit in their own contiguous
+// arrays; price and the descriptive strings live in parallel side tables.
+struct EdgeStore {
+    // hot: read on every relaxation
+    std::vector<int32_t> base;
+    std::vector<int32_t> quote;
+    std::vector<double> marketWeight;       // -log(price) for Bellman-Ford
+    std::vector<int32_t> marketTicks;       // the same in fixed point, toTicks(marketWeight)
+
+    // cold: read when a cycle is reported
+    std::vector<double> marketPrice;        // actual exchange rate
+    std::vector<int32_t> marketExchange;    // interned id of "Binance", "OKX", "Cross"
+    std::vector<std::string> marketSymbol;  // trading pair symbol
+
+    // edge id layout, derived from the records and their peers
+    std::vector<int32_t> firstEdge{0};      // record -> first edge id, size markets() + 1
+    std::vector<int32_t> edgeRecord;        // edge id -> record
+    std::vector<int32_t> edgePeer;          // edge id -> the record's other end on that arc
+
+    size_t size() const { return edgeRecord.size(); }   // edges, both sides
+    size_t markets() const { return base.size(); }
+
+    int record(int e) const { return edgeRecord[e]; }
+    int src(int e) const { return e & 1 ? quote[edgeRecord[e]] : edgePeer[e]; }
+    int dst(int e) const { return e & 1 ? edgePeer[e] : quote[edgeRecord[e]]; }
+    double weight(int e) const { return e & 1 ? -marketWeight[edgeRecord[e]] : marketWeight[edgeRecord[e]]; }
+    int32_t ticks(int e) const { return e & 1 ? -marketTicks[edgeRecord[e]] : marketTicks[edgeRecord[e]]; }
+    double price(int e) const { return e & 1 ? 1.0 / marketPrice[edgeRecord[e]] : marketPrice[edgeRecord[e]]; }
+    int exchange(int e) const { return marketExchange[edgeRecord[e]]; }
+
+    void set(int e, double w, double p) {   // w, p as seen from edge e, for all of its record
+        const int r = edgeRecord[e];
+        marketWeight[r] = e & 1 ? -w : w;
+        marketTicks[r] = toTicks(marketWeight[r]);
+        marketPrice[r] = e & 1 ? 1.0 / p : p;
+    }
+
+    int push_back(int s, int d, double w, double p,       // market s -> d
+                  int exch, const std::string& sym) {
+        return push_back(s, d, w, p, exch, sym, &s, 1);
+    }
+
+    int push_back(int s, int d, double w, double p,       // record with arcs to every peer
+                  int exch, const std::string& sym,
+                  const int32_t* peers, int peerCount) {
+        const int r = static_cast<int>(base.size());
+        base.push_back(s);
+        quote.push_back(d);
+        marketWeight.push_back(w);
+        marketTicks.push_back(toTicks(w));
+        marketPrice.push_back(p);
+        marketExchange.push_back(exch);
+        marketSymbol.push_back(sym);
+        for (int i = 0; i < peerCount; ++i) {
+            edgeRecord.insert(edgeRecord.end(), 2, r);
+            edgePeer.insert(edgePeer.end(), 2, peers[i]);
+        }
+        firstEdge.push_back(static_cast<int32_t>(edgeRecord.size()));
+        return firstEdge[r];
+    }
+};
+
+// === Edge Handle ===
+// Resolved once per market; lets price ticks skip node/edge lookups.
+struct EdgeHandle {
+    int32_t forward = -1;                   // edge id of base -> quote (its inverse is forward + 1)
+    bool cross = false;                     // Cross bridge: only price 1.0 accepted
+
+    bool valid() const { return forward >= 0; }
+};
+
+// === Detected Cycle ===
+struct DetectedCycle {
+    std::vector<int> nodes;                 // cycle in traversal order (no repeat)
+    double profit;                          // product of edge prices
+};
+
+// === Relaxation Kernel ===
+enum class RelaxKernel {
+    BellmanFord,                            // V-1 full passes, then collectCycles()
+    Queue                                   // SPFA with subtree disambiguation
+};
+
+// === Vectorized Relaxation ===
+enum class SimdLevel {
+    Scalar,                                 // one edge at a time
+    Avx2,                                   // 4 edges per step
+    Avx512                                  // 8 edges per step
+};
+SimdLevel detectSimdLevel();                // best level this CPU and OS support
+constexpr int RELAX_BATCH = 8;              // sources relaxed together by relaxBatchPass()
+const char* simdLevelName(SimdLevel level);
+
+// One Bellman-Ford pass over a CSR-shaped span: node slot i is node
+// nodes[i] (or i when nodes is null) and owns edge slots
+// [outStart[i], outStart[i+1]) of dst/weight/ids. A node's out-edges have
+// distinct destinations, which is what lets a whole block of them be
+// tested and written at once. In a batched pass dist/parent/parentEdge are
+// node-major V x RELAX_BATCH (one lane per source) and lastPass is per node,
+// set when any lane lowers it.
+struct RelaxSpan {
+    const int32_t* nodes = nullptr;
+    int nodeCount = 0;
+    const int32_t* outStart = nullptr;
+    const int32_t* dst = nullptr;
+    const double* weight = nullptr;
+    const int32_t* ids = nullptr;           // edge slot -> edge id
+    double eps = 0.0;                       // gains below this are ignored
+    double* dist = nullptr;
+    int* parent = nullptr;
+    int* parentEdge = nullptr;
+    int32_t* lastPass = nullptr;            // node -> pass that last lowered it
+};
+
+// The same walk in float32 for the screening pass: twice the lanes per
+// vector and half the bytes per weight and distance. No predecessors are
+// kept, and a distance is lowered on any strict improvement (no eps).
+struct ScreenSpan {
+    const int32_t* nodes = nullptr;
+    int nodeCount = 0;
+    const int32_t* outStart = nullptr;
+    const int32_t* dst = nullptr;
+    const float* weight = nullptr;
+    float* dist = nullptr;
+    int32_t* lastPass = nullptr;            // node -> pass that last lowered it
+};
+
+// One min-plus product over dense row-major matrices with rows of `stride`
+// doubles (a multiple of MINPLUS_TILE, padding set to inf):
+// c[i][j] = min over m < n of a[i][m] + b[m][j], and arg[i][j] is the m
+// that gave it (-1 while c[i][j] is inf). Rows past n are not written.
+constexpr int MINPLUS_TILE = 32;
+struct MinPlusSpan {
+    const double* a = nullptr;
+    const double* b = nullptr;
+    double* c = nullptr;
+    int32_t* arg = nullptr;
+    int n = 0;
+    int stride = 0;
+};
+
+// One layer of the fixed-point hop-bounded search: every frontier node x
+// offers prev[x] + ticks over its CSR slots to next[y], skipping y below
+// `floor`. A node's out-edges lead to distinct nodes, so a block of them is
+// tested and written at once; integer sums make the layer identical at
+// every SIMD width. Nodes reached for the first time (next was TICK_INF)
+// are appended to `reached`.
+struct TickLayerSpan {
+    const int32_t* frontier = nullptr;
+    int frontierCount = 0;
+    const int32_t* outStart = nullptr;      // node -> first CSR slot
+    const int32_t* dst = nullptr;
+    const int32_t* ticks = nullptr;
+    const int32_t* ids = nullptr;           // CSR slot -> edge id
+    int floor = 0;                          // lowest node walked through
+    const int32_t* prev = nullptr;          // node -> ticks of the previous layer
+    int32_t* next = nullptr;                // node -> ticks of this layer
+    int32_t* pred = nullptr;                // node -> edge id that set next
+    std::vector<int32_t>* reached = nullptr;
+};
+
+// === Certificate Counters ===
+struct CertificateStats {
+    uint64_t ticks = 0;                     // full-detector calls past warmup
+    uint64_t skipped = 0;                   // of those, skipped because the certificate held
+};
+
+// === Published Graph Image ===
+// Flat copy of everything detection reads. The ingest thread fills one from
+// its writer Graph and the detector thread imports it into its own Graph;
+// topology arrays are only re-copied when the writer's topology moved, and
+// prices only for the markets the writer's journal lists since the image's
+// last fill.
+struct GraphImage {
+    uint64_t topologyVersion = UINT64_MAX;  // writer topology the arrays reflect
+    uint64_t priceSeq = 0;                  // writer price journal position the prices reflect
+    bool warmStarted = false;
+    std::vector<std::string> assetNames;
+    std::vector<std::string> exchangeNames;
+    std::vector<int32_t> nodeAsset;
+    std::vector<int32_t> nodeExchange;
+    std::vector<int32_t> marketBase;        // one entry per market, as in EdgeStore
+    std::vector<int32_t> marketQuote;
+    std::vector<int32_t> marketExchange;
+    std::vector<std::string> marketSymbol;
+    std::vector<double> marketWeight;
+    std::vector<double> marketPrice;
+};
+
+// === Worker Pool ===
+// Fixed set of threads that all run the same job on every run() call;
+// run() returns once each worker has finished its share.
+class WorkerPool {
+public:
+    explicit WorkerPool(int threads);
+    ~WorkerPool();
+    int size() const { return static_cast<int>(threads.size()); }
+    void run(const std::function<void(int)>& job); // job(worker index) on every worker
+
+private:
+    void loop(int worker);
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(int)>* job = nullptr;
+    uint64_t generation = 0;                       // bumped per run()
+    int running = 0;                               // workers still on the current job
+    bool stopping = false;
 };
 
 // === Graph Class ===
 class Graph {
 private:
+    // === Interned Identifiers ===
+    std::unordered_map<std::string, int> assetIds;     // asset symbol -> asset id
+    std::vector<std::string> assetNames;               // asset id -> symbol
+    std::unordered_map<std::string, int> exchangeIds;  // exchange name -> exchange id
+    std::vector<std::string> exchangeNames;            // exchange id -> name
+    int crossExchangeId = -1;                          // id of the "Cross" pseudo-exchange
+
+    static constexpr int NO_EXCHANGE = -1;             // node without exchange suffix
+
+    static uint64_t nodeKey(int asset, int exchange) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(asset)) << 32) |
+               static_cast<uint32_t>(exchange + 1);
+    }
+    int internAsset(const std::string& asset);
+    int internExchange(const std::string& exchange);
+    int nodeFromName(const std::string& name);         // "BTC_Binance" -> node id
+
     // === Core Graph Data ===
-    std::unordered_map<std::string, int> nodeIds;  // node name -> ID mapping
-    std::vector<std::string> nodeNames;            // ID -> node name mapping
-    std::vector<Edge> edges;                       // all graph edges
+    std::unordered_map<uint64_t, int> nodeIds;     // (asset id, exchange id) -> node id
+    std::vector<int> nodeAsset;                    // node id -> asset id
+    std::vector<int> nodeExchange;                 // node id -> exchange id (or NO_EXCHANGE)
+    std::vector<std::string> nodeNames;            // node id -> display name, built once per node
+    EdgeStore edges;                               // all markets, hence all edges
+    std::unordered_map<uint64_t, int> edgeIndex;   // (lower node, higher node) -> record
+    std::vector<std::vector<int32_t>> bridgeMembers; // asset -> bridged nodes in join order, first is the base of their records
+
+    static uint64_t edgeKey(int u, int v) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(u)) << 32) | static_cast<uint32_t>(v);
+    }
+    int findEdge(int u, int v) const;              // edge id or -1
+    int insertEdge(int u, int v, double w, double p, // new record, returns the id of u -> v
+                   int exch, const std::string& sym);
+    bool isBridge(int u, int v, int exch) const {  // Cross record between nodes of one asset
+        return exch != NO_EXCHANGE && exch == crossExchangeId && u != v && nodeAsset[u] == nodeAsset[v];
+    }
+    double updateEdge(int u, int v, double p, int exch, const std::string& sym);
+    void setEdgeWeight(int e, double w, double p); // weight-only update of e's record (edges + CSR)
+
+    // === CSR Adjacency ===
+    // Out-edges grouped per source node. Rebuilt lazily when the topology
+    // version moves (node or edge added); weight-only updates write straight
+    // into csrWeight and csrTicks through edgeCsrSlot.
+    uint64_t topologyVersion = 0;                  // bumped on node/edge insertion
+    uint64_t csrVersion = UINT64_MAX;              // topology version the CSR reflects
+    std::vector<int32_t> csrOffsets;               // node -> first slot, size V+1
+    std::vector<int32_t> csrDst;                   // slot -> destination node
+    std::vector<double> csrWeight;                 // slot -> weight
+    std::vector<int32_t> csrTicks;                 // slot -> weight in fixed point
+    std::vector<int32_t> csrEdge;                  // slot -> edge id
+    std::vector<int32_t> edgeCsrSlot;              // edge id -> slot
+    void ensureCsr();                              // rebuild if topology changed
+    bool csrCurrent() const { return csrVersion == topologyVersion; }
+
+    // === Cyclic Components ===
+    // Strongly connected components (Tarjan) of the graph left after peeling
+    // nodes with fewer than two distinct neighbours, which cannot sit on a
+    // cycle of MIN_CYCLE_LEN or more. Components smaller than that are
+    // dropped too. Rebuilt only when the topology version moves.
+    uint64_t sccVersion = UINT64_MAX;              // topology version the components reflect
+    std::vector<int32_t> sccOf;                    // node -> component, -1 if on no cycle
+    std::vector<int32_t> cyclicNodes;              // nodes with sccOf >= 0, ascending
+    std::vector<int32_t> sccNodeStart;             // component -> first slot in sccNodes
+    std::vector<int32_t> sccNodes;                 // slot -> node
+    std::vector<int32_t> sccEdgeStart;             // component -> first slot in sccEdges
+    std::vector<int32_t> sccOutStart;              // sccNodes slot -> first of its out-edge slots
+    std::vector<int32_t> sccEdges;                 // slot -> edge id, grouped by component then source
+    std::vector<int32_t> sccDst;                   // slot -> destination node
+    std::vector<double> sccWeight;                 // slot -> weight, kept in sync like csrWeight
+    std::vector<int32_t> edgeSccSlot;              // edge id -> slot, -1 if between components
+    void ensureScc();
+    void printSccStats(const char* prefix) const;  // what the last ensureScc() kept
+
+    // === Bridge Contraction ===
+    // Opt-in, Bellman-Ford kernel only. Nodes joined both ways by Cross
+    // bridges (price 1.0) collapse onto their lowest id, so cyclicNodes and
+    // sccNodes hold representatives only and the Cross edges vanish from the
+    // sccEdges slots. Parallel markets between two groups share one slot,
+    // which carries the cheapest of them. Cycles are expanded back to
+    // per-exchange nodes before screening.
+    bool contractBridges = false;
+    bool sccContracted = false;                    // mode the component arrays were built in
+    std::vector<int32_t> bridgeRep;                // node -> representative (itself if alone)
+    std::vector<int32_t> sccMemberStart;           // slot -> first of its edges in sccMembers
+    std::vector<int32_t> sccMembers;               // edges merged into each slot
+    bool contractingBridges() const { return contractBridges && relaxKernel == RelaxKernel::BellmanFord; }
+    bool expandBridges(std::vector<int>& cycle,    // rewrite a representative cycle
+                       std::vector<int>& cycleEdgeIdx) const;
+
+    // === Change Tracking ===
+    // Edges whose weight moved since the last incremental pass. Only edges a
+    // consumer has sized edgeChanged for are tracked, so the list stays empty
+    // (and bounded by E) in modes that never drain it.
+    std::vector<int32_t> changedEdges;             // edge ids, each queued at most once
+    std::vector<uint8_t> edgeChanged;              // edge id -> already queued
+
+    // === Feasibility Certificate ===
+    // Potential from the last full pass under which every edge had
+    // w + potential[u] - potential[v] >= 0, i.e. no negative cycle existed.
+    // setEdgeWeight() re-tests each changed edge against it; while none
+    // breaks it the full detectors can skip the tick.
+    std::vector<double> certPotential;             // node -> potential
+    bool certHolds = false;                        // no edge broken or inserted since
+    CertificateStats certStats;
+    bool certificateSkip();                        // count the tick, true if it can be skipped
+    void rebuildCertificate();                     // after a full pass
+
+    // === Price Fast Path ===
+    struct TickFields {                            // reused across messages, no per-tick allocation
+        std::string base, quote, exchange, symbol;
+        double price = 0.0;
+        bool hasPrice = false;
+    };
+    TickFields tick;
+    std::vector<std::unordered_map<std::string, EdgeHandle>> priceHandles; // [exchange id] symbol -> handle
+    EdgeHandle resolveNodes(int u, int v, int exch) const;
+    int findNode(const std::string& asset, int exchangeId) const;
+    int findNodeByName(const std::string& name) const;
 
     // === Cycle Deduplication ===
     std::deque<std::string> recentCycles;          // LRU cache of cycle signatures
@@ -52,24 +403,389 @@ private:
     static constexpr double EPS_BUCKET = 1e-6;
 
     // === Super-Source Algorithm Support ===
+    // The super-source has no stored edges: a run from it starts every node
+    // at distance 0 with the super-source as parent, which is where its
+    // zero-weight link to each node would put them.
     int superSourceId = -1;                        // super-source node ID
-    size_t lastSuperEdgeAddForNodeCount = 0;       // track when to add new edges
 
     // === Benchmark Statistics ===
+    // Work done by one kernel run from one source.
+    struct KernelWork {
+        long long edges = 0;                       // edges actually scanned
+        int passes = 0;                            // bf kernel: passes run
+        int passBound = 0;                         // bf kernel: |V|-1 (or |C|-1)
+    };
     struct BenchmarkStats {
         int cyclesFound = 0;
         double totalTime = 0.0;
         int bellmanFordRuns = 0;
-        int edgesProcessed = 0;
+        long long edgesProcessed = 0;
+        long long relaxPasses = 0;                 // bf kernel: passes actually run
+        long long relaxPassBound = 0;              // bf kernel: passes a fixed loop would run
+        int maxRelaxPasses = 0;                    // bf kernel: longest single run
+        int policyIterations = 0;                  // min-mean mode only
+        int matrixProducts = 0;                    // tropical mode only
+
+        void addRun(const KernelWork& w) {
+            edgesProcessed += w.edges;
+            relaxPasses += w.passes;
+            relaxPassBound += w.passBound;
+            maxRelaxPasses = std::max(maxRelaxPasses, w.passes);
+        }
     };
     BenchmarkStats statsClassic;
     BenchmarkStats statsSuper;
+    BenchmarkStats statsHoward;
+    BenchmarkStats statsTropical;
+    void printRelaxPasses(const BenchmarkStats& stats) const;
+
+    // === Bellman-Ford Kernel ===
+    // Passes stop as soon as one lowers nothing, and an edge is only scanned
+    // if its source was lowered since the edge's previous scan.
+    KernelWork relaxFromSource(int start,
+                               std::vector<double>& dist,
+                               std::vector<int>& parent,
+                               std::vector<int>& parentEdge,
+                               std::vector<int32_t>& lastPass, // node -> pass that last lowered it
+                               int comp = -1) const; // comp >= 0: that component only
+    RelaxSpan spanFor(int comp) const;             // component edges, or the whole CSR for -1
+    void collectCycles(const std::vector<double>& dist,
+                       std::vector<int>& parent,
+                       std::vector<int>& parentEdge,
+                       std::vector<DetectedCycle>& found,
+                       bool dedup = true,          // false: filters only, safe off-thread
+                       int comp = -1);
+
+    // === Vectorized Relaxation (GraphSimd.cpp) ===
+    // The AVX2/AVX-512 passes walk a node's out-edges a block at a time:
+    // broadcast dist[src], add the weights, gather dist[dst], compare. The
+    // destinations in a block are distinct, so improving lanes never
+    // conflict and are written back in slot order, exactly as the scalar
+    // pass does; results match it bit for bit.
+    SimdLevel simdLevel = detectSimdLevel();
+    long long relaxPass(const RelaxSpan& span, int pass, bool& lowered) const; // returns edges scanned
+    // Same walk for RELAX_BATCH sources at once: each edge is loaded once
+    // and relaxed in every lane, so the loop vectorizes across sources and
+    // needs no gather. A lane's writes are those of its own single-source
+    // pass (an inactive lane cannot improve anything).
+    long long relaxBatchPass(const RelaxSpan& span, int pass, bool& lowered) const;
+    // Min-plus product, tiled MINPLUS_TILE x MINPLUS_TILE over (i, m, j) so
+    // the three tiles stay in L1; the j loop is the vector one. Ties keep
+    // the lowest m, so every level gives the same result.
+    void minPlusProduct(const MinPlusSpan& span) const;
+    // Float32 pass for the screen, same walk as relaxPass().
+    long long screenPass(const ScreenSpan& span, int pass, bool& lowered) const;
+    // One fixed-point hop-bounded layer; int32 ticks fit twice as many
+    // lanes per vector as doubles (8 for AVX2, 16 for AVX-512).
+    void relaxTickLayer(const TickLayerSpan& span) const;
+
+    // === Queue Kernel ===
+    // SPFA over the CSR. The shortest-path tree is kept as a preorder thread
+    // (next/prev/depth); when a node improves, its subtree is detached, and
+    // if the improving edge starts inside that subtree it closes a negative
+    // cycle right away. The first such cycle that passes the filters ends
+    // the run (at most one per source, like one collectCycles() pass); a
+    // closing edge whose cycle fails them is disabled for the rest of the
+    // run, so the search still terminates.
+    struct KernelScratch {
+        std::vector<int32_t> lastPass;             // bf kernel: node -> pass that last lowered it
+        std::vector<double> batchDist;             // batched bf: node * RELAX_BATCH + lane -> dist
+        std::vector<int> batchParent;              // batched bf: same layout -> parent node
+        std::vector<int> batchParentEdge;          // batched bf: same layout -> parent edge
+        std::vector<int32_t> next;                 // node -> next node in preorder
+        std::vector<int32_t> prev;                 // node -> previous node in preorder
+        std::vector<int32_t> depth;                // node -> depth in the tree
+        std::vector<uint8_t> inTree;               // node -> attached to the tree
+        std::vector<uint8_t> inQueue;              // node -> waiting to be scanned
+        std::deque<int32_t> queue;
+        std::vector<uint8_t> disabled;             // CSR slot -> closed a reported cycle
+        std::vector<int32_t> disabledSlots;        // slots to re-enable after the run
+    };
+    KernelScratch ks;
+    RelaxKernel relaxKernel = RelaxKernel::BellmanFord;
+    long long relaxQueueFromSource(int start,      // returns edges scanned
+                                   std::vector<double>& dist,
+                                   std::vector<int>& parent,
+                                   std::vector<int>& parentEdge,
+                                   std::vector<DetectedCycle>& found,
+                                   KernelScratch& q,
+                                   bool dedup,
+                                   int comp);
+    KernelWork runKernel(int start,                // selected kernel + cycle extraction
+                         std::vector<double>& dist,
+                         std::vector<int>& parent,
+                         std::vector<int>& parentEdge,
+                         std::vector<DetectedCycle>& found);
+    KernelWork runKernel(int start,                // same, on caller-owned scratch
+                         std::vector<double>& dist,
+                         std::vector<int>& parent,
+                         std::vector<int>& parentEdge,
+                         std::vector<DetectedCycle>& found,
+                         KernelScratch& q,
+                         bool dedup,
+                         int comp);                // -1: whole graph
+    KernelWork runBatch(const int32_t* sources,    // relax up to RELAX_BATCH sources of comp
+                        int count,                 // together, screen each lane's cycles
+                        int comp,                  // into sourceCycles[source]
+                        std::vector<double>& dist,
+                        std::vector<int>& parent,
+                        std::vector<int>& parentEdge,
+                        KernelScratch& q);
+
+    // === Float32 Screening ===
+    // Opt-in (--float-screen) for classic mode without bridge contraction.
+    // Before the per-source passes, each component of n nodes gets one
+    // float32 Bellman-Ford from an implicit zero source over its weights
+    // re-based on treePotential() and raised by delta = 7/8 log(PROFIT_MIN_LOCAL)
+    // / n per edge. If that settles, the rounding it could have hidden is
+    // measured edge by edge (err); a simple cycle then weighs at least
+    // -n * (delta + err), and when that stays above -log(PROFIT_MIN_LOCAL) no
+    // cycle of the component can pass screenCycle(), so its sources are
+    // skipped. Everything else runs in double as before.
+    struct FloatScreen {
+        std::vector<double> potential;             // node -> tree potential
+        std::vector<int32_t> queue;                // BFS order
+        std::vector<float> weight;                 // scc slot -> re-based weight + delta
+        std::vector<float> dist;                   // node -> distance from the implicit source
+        std::vector<int32_t> lastPass;             // node -> pass that last lowered it
+        std::vector<uint8_t> cleared;              // component -> proven free this tick
+        uint64_t scans = 0;                        // components screened
+        uint64_t clearedScans = 0;                 // of those, cleared
+    };
+    bool floatScreen = false;
+    FloatScreen screen;
+    void screenComponents();                       // fill screen.cleared for this tick
+    bool screenComponent(int comp);                // true if no cycle can reach PROFIT_MIN_LOCAL
+    void printScreenStats(const char* prefix) const;
+
+    // === Parallel Classic Mode (GraphParallel.cpp) ===
+    // Workers pull tasks off a shared counter (a batch of one component's
+    // sources for Bellman-Ford, one source for the queue kernel) and run them
+    // on their own scratch, screening cycles without touching the dedup
+    // cache. The caller then dedups source by source, so the output matches
+    // a serial run whatever the thread count. With one thread the tasks run
+    // on the caller.
+    struct SourceScratch {
+        std::vector<double> dist;
+        std::vector<int> parent;
+        std::vector<int> parentEdge;
+        KernelScratch q;
+    };
+    int detectionThreads = 1;
+    std::unique_ptr<WorkerPool> pool;
+    std::vector<SourceScratch> workerScratch;      // worker -> scratch
+    std::vector<std::vector<DetectedCycle>> sourceCycles; // source -> screened cycles
+    void ensurePool();                             // (re)start the pool for detectionThreads > 1
+    void collectSources();                         // fill sourceCycles for every cyclic node
+
+    // === Incremental Detection ===
+    // A potential kept across ticks with weight + potential[u] - potential[v]
+    // >= 0 on every edge that is not pending. A changed edge that breaks this
+    // is repaired by a Dijkstra over reduced costs that only visits nodes whose
+    // potential actually drops; popping the edge's own source closes a
+    // negative cycle through it, and the edge stays pending until that cycle
+    // is gone.
+    struct IncrementalState {
+        size_t knownEdges = 0;                     // edges the state has been sized for
+        std::vector<double> potential;             // node -> potential
+        std::vector<double> key;                   // node -> tentative drop (0 = untouched)
+        std::vector<int32_t> parentEdge;           // node -> edge that lowered it
+        std::vector<uint8_t> settled;              // node -> popped in the current repair
+        std::vector<int32_t> touched;              // nodes to reset after a repair
+        std::vector<std::pair<double, int32_t>> heap;
+        std::vector<int32_t> pending;              // edges closing a live negative cycle
+        std::vector<uint8_t> isPending;            // edge id -> in pending
+    };
+    IncrementalState incr;
+    bool repairPotential(int e, std::vector<DetectedCycle>& found);
+
+    // === Short-Cycle Index ===
+    // Every simple cycle of MIN_CYCLE_LEN..maxLen edges, enumerated once per
+    // topology version (each cycle once, rooted at its smallest node). An
+    // edge -> cycles inverted list means a tick only re-sums the cycles that
+    // run through the edges it moved.
+    struct ShortCycleIndex {
+        int maxLen = 4;                            // longest cycle indexed
+        uint64_t topology = UINT64_MAX;            // topology version enumerated
+        int nodes = 0;                             // nodes it was enumerated over
+        std::vector<int32_t> cycleStart;           // cycle -> first slot in cycleEdges, size C+1
+        std::vector<int32_t> cycleEdges;           // slot -> edge id, in traversal order
+        std::vector<double> sum;                   // cycle -> total log-weight
+        std::vector<int32_t> edgeStart;            // edge -> first slot in edgeCycles, size E+1
+        std::vector<int32_t> edgeCycles;           // slot -> cycle id
+        std::vector<uint8_t> dirty;                // cycle -> queued for re-summing
+        std::vector<int32_t> dirtyCycles;
+        std::vector<int32_t> path;                 // edges of the walk being extended
+        std::vector<uint8_t> onPath;               // node -> on that walk
+    };
+    ShortCycleIndex shortCycles;
+    void rebuildShortCycles();
+    void printShortCycleStats(const char* prefix) const; // what the last rebuild indexed
+    void extendShortCycles(int start, int x);
+    void checkShortCycle(int c, std::vector<DetectedCycle>& found);
+
+    // === Hop-Bounded Detection ===
+    // Layered Bellman-Ford: layer k holds the cheapest walk of exactly k
+    // edges from the source, with its own predecessor, so L rounds of E
+    // replace V-1 passes. Sources only walk through nodes numbered above
+    // themselves, so each cycle is searched from its smallest node once.
+    // With fixedPoint set the layers hold int32 tick sums instead (at most
+    // TICK_MAX_HOPS of them), which are exact; profit is still the double
+    // price product, taken when a cycle is reported.
+    struct HopBoundedScratch {
+        std::vector<double> dist;                  // layer * V + node -> walk weight
+        std::vector<int32_t> ticks;                // layer * V + node -> walk ticks (fixed point)
+        std::vector<int32_t> pred;                 // layer * V + node -> last edge id
+        std::vector<int32_t> touched;              // finite entries, reset per source
+        std::vector<int32_t> frontier;             // nodes reached in the current layer
+        std::vector<int32_t> nextFrontier;
+        std::vector<int32_t> walk;                 // closed walk being decomposed (edge ids)
+        std::vector<int32_t> stackNodes;
+        std::vector<int32_t> stackEdges;
+        std::vector<int32_t> pos;                  // node -> index on stackNodes, -1 if off
+    };
+    HopBoundedScratch hop;
+    int maxHops = 10;                              // mirrors MAX_CYCLE_LENGTH in config/settings.py
+    bool fixedPoint = false;                       // --fixed-point
+    int hopLimit() const;                          // layers searched, L
+    int hopBoundedLayers(int s);                   // best layer closing at s, -1 if none
+    int hopBoundedTickLayers(int s);               // the same over csrTicks
+    void bestHopBoundedCycle(int s, std::vector<DetectedCycle>& found);
+
+    // === Dynamic All-Pairs Shortest Paths ===
+    // Dense V x V distance matrix with the first edge of every stored path,
+    // built by cache-tiled Floyd-Warshall over weights raised by a per-hop
+    // margin. The matrix never holds a negative cycle: a changed edge u -> v
+    // with w + dist[v][u] < 0 closes one with the stored path v -> u, so it
+    // is reported and held at its old weight until the cycle is gone. Any
+    // other cheaper edge is folded in O(V^2) (i -> j may now run i -> u ->
+    // v -> j). A dearer one that a stored path leaves u through is not
+    // folded, leaving lower bounds, and V of those force a rebuild.
+    struct AllPairsState {
+        uint64_t topology = UINT64_MAX;            // topology version built for
+        int n = 0;                                 // nodes covered
+        int stride = 0;                            // row length: n rounded up to whole tiles
+        int loosened = 0;                          // dearer edges folded as lower bounds since the rebuild
+        std::vector<double> dist;                  // i * stride + j -> shortest i -> j weight
+        std::vector<int32_t> next;                 // i * stride + j -> first edge of that path, -1 if none
+        std::vector<double> weight;                // edge id -> weight last settled (inf = left out)
+        std::vector<uint8_t> held;                 // edge id -> 1 while it closes a negative cycle
+        std::vector<int> heldEdges;                // edges with held set, rechecked every tick
+        std::vector<double> colDist;               // column u and row v as they were
+        std::vector<int32_t> colNext;              // before the current fold
+        std::vector<double> rowDist;
+        long long folds = 0;                       // changed edges settled in place
+        long long rebuilds = 0;                    // full Floyd-Warshall runs
+    };
+    AllPairsState apsp;
+    void rebuildAllPairs(std::vector<DetectedCycle>& found);
+    void foldAllPairsEdge(int e);
+    bool settleAllPairsEdge(int e, std::vector<DetectedCycle>& found);
+
+    // === Tropical Cycle Scoring ===
+    // Min-plus powers of the dense log-weight matrix W (inf where no market):
+    // layer k holds W^k, the cheapest walk of exactly k edges between every
+    // pair, so its diagonal is the cheapest closed k-walk through each node.
+    // Layers run k = 1..maxLen (--cycle-len) and are recomputed every tick.
+    struct TropicalState {
+        uint64_t topology = UINT64_MAX;            // topology version the edge map is for
+        int n = 0;                                 // nodes covered
+        int stride = 0;                            // row length: n rounded up to whole tiles
+        int maxLen = 0;                            // layers held
+        std::vector<int32_t> edge;                 // i * stride + j -> edge i -> j, -1 if none
+        std::vector<double> power;                 // (k - 1) * stride^2 + i * stride + j -> W^k
+        std::vector<int32_t> arg;                  // same index, k >= 2 -> node before j on that walk
+    };
+    TropicalState tropical;
+    void computeTropicalPowers();
+    void collectTropicalCycles(std::vector<DetectedCycle>& found); // negative diagonals, k >= MIN_CYCLE_LEN
+    bool tropicalCycle(int i, int k, std::vector<int>& cycle, std::vector<int>& cycleEdgeIdx) const;
+
+    // === Top-K Cycle Search ===
+    // Branch-and-bound DFS over the CSR from every start node through nodes
+    // numbered above it, so each simple cycle of MIN_CYCLE_LEN..maxHops edges
+    // is met once, from its smallest node. Weights are re-based on a
+    // potential laid along a BFS forest (tree markets and their inverses drop
+    // to 0, every cycle keeps its sum), and bound[r * V + x] is the cheapest
+    // walk of 1..r re-based edges out of x: a step whose sum plus that bound
+    // cannot beat the K-th best cycle so far is cut. Start nodes are shared
+    // out over the worker pool; each worker keeps its own K best, which
+    // always hold the K best of the starts it searched.
+    struct TopKWorker {
+        std::vector<std::pair<double, std::vector<int32_t>>> best; // max-heap on sum: cycle edge ids
+        std::vector<int32_t> path;                 // edges of the walk being extended
+        std::vector<uint8_t> onPath;               // node -> on that walk
+        long long expanded = 0;                    // steps taken
+        long long cut = 0;                         // steps cut by the bound
+    };
+    struct TopKState {
+        int k = 10;                                // cycles kept per tick
+        std::vector<double> potential;             // node -> potential
+        std::vector<int32_t> queue;                // BFS order
+        std::vector<double> reduced;               // csr slot -> re-based weight
+        std::vector<int32_t> order;                // csr slots of each node, cheapest re-based first
+        std::vector<double> bound;                 // r * V + node, r = 0..maxHops (row 0 = inf)
+        std::vector<TopKWorker> workers;
+        long long expanded = 0;                    // totals since start
+        long long cut = 0;
+    };
+    TopKState topK;
+    void prepareTopK();                            // potential, re-based weights, bounds
+    void extendTopK(TopKWorker& w, int start, int x, double sum);
+    void collectTopKCycles(std::vector<std::pair<double, std::vector<int32_t>>>& best); // K best, cheapest first
+
+    // === Minimum Mean Cycle (Howard) ===
+    // Policy iteration: every live node follows one out-edge, so each policy
+    // component ends in exactly one cycle. Evaluation gives each node the
+    // mean weight of the cycle it reaches (eta) and a bias (d); improvement
+    // first moves nodes to successors with a lower eta, then, if none did,
+    // to successors with a lower bias. The policy is kept between calls so
+    // a tick that barely moves prices converges in one or two iterations.
+    struct HowardState {
+        std::vector<int32_t> policy;               // node -> chosen out-edge id (-1 if dead)
+        std::vector<uint8_t> alive;                // node -> lies on or leads to some cycle
+        std::vector<double> eta;                   // node -> mean weight of its policy cycle
+        std::vector<double> d;                     // node -> bias relative to that cycle
+        std::vector<uint8_t> mark;                 // node -> 0 new, 1 on walk, 2 evaluated
+        std::vector<int32_t> path;                 // current policy walk
+        std::vector<int> cycle;                    // best cycle of the last run
+        std::vector<int> cycleEdges;               // its edges, cycle[i] -> cycle[i + 1]
+        double bestMean = 0.0;                     // its mean weight (negative = arbitrage)
+    };
+    HowardState howard;
+    int runHoward();                               // returns policy iterations
+    void evaluatePolicy();
+    bool improvePolicy();
+
+    // === Cycle Reporting ===
+    bool screenCycle(const std::vector<int>& cycle,   // price product and filters
+                     const std::vector<int>& cycleEdgeIdx,
+                     double& profit) const;
+    bool acceptCycle(const std::vector<int>& cycle,   // screenCycle + dedup
+                     const std::vector<int>& cycleEdgeIdx,
+                     double& profit);
+    void announceCycle(const char* prefix, const DetectedCycle& fc);
+    bool rollSecondSummary(const char* prefix, std::time_t& lastSecond, int& foundThisSecond);
+    void printCertificateStats(const char* prefix) const;
 
     // === Helper Functions ===
-    void ensureSuperSourceEdges();                 // create/update super-source connections
+    void ensureSuperSource();                      // create the super-source node (links are implicit)
+    void treePotential(std::vector<double>& potential, // BFS-forest potential over the CSR: re-based
+                       std::vector<int32_t>& queue) const; // weights are 0 on tree edges, cycle sums kept
     bool warmupActive();                           // check if in warmup period
+    bool warmStarted = false;                      // graph restored from snapshot, skip warmup
+    void resetGraph();                             // drop all nodes and edges
+    uint64_t importedTopology = UINT64_MAX;        // writer topology of the last imported image
+    // Markets whose price moved, in order (with repeats). An image filled
+    // at journal position s only needs the entries after s; the journal is
+    // dropped once it outgrows the market count, and images older than
+    // that get a full copy.
+    std::vector<int32_t> priceJournal;             // market ids
+    uint64_t priceJournalStart = 0;                // journal position of priceJournal[0]
     void findArbitrageQuiet(BenchmarkStats& stats);           // silent classic mode for benchmark
     void findArbitrageSuperSourceQuiet(BenchmarkStats& stats); // silent super-source for benchmark
+    void findMinMeanCycleQuiet(BenchmarkStats& stats);        // silent min-mean for benchmark
+    void findTropicalQuiet(BenchmarkStats& stats);            // silent tropical for benchmark
 
     // === CSV Logging ===
     std::ofstream csvLogger;
@@ -80,20 +796,46 @@ private:
 
 public:
     // === Graph Construction ===
-    int addNode(std::string name);
-    double addOrUpdateEdge(std::string source,
-                           std::string destination,
+    int addNode(int assetId, int exchangeId);
+    int addNode(const std::string& name);
+    double addOrUpdateEdge(const std::string& source,
+                           const std::string& destination,
                            double price,
                            const std::string& exchange = "",
                            const std::string& symbol = "");
 
+    // === Price Updates ===
+    EdgeHandle resolve(const std::string& base,
+                       const std::string& quote,
+                       const std::string& exchange) const;
+    double updatePrice(const EdgeHandle& h, double price);
+
     // === Data Processing ===
-    void processMessage(std::string msg);          // parse and add edge from JSON
+    void processMessage(const std::string& msg);   // parse and add edge from JSON
 
     // === Arbitrage Detection ===
     void findArbitrage();                          // classic multi-source Bellman-Ford
     void findArbitrageSuperSource();               // super-source single-run Bellman-Ford
+    void findArbitrageIncremental();               // repair potentials around changed edges
+    void findMinMeanCycle();                       // Howard policy iteration, best-ratio cycle
+    void findArbitrageShortCycles();               // re-sum indexed cycles through changed edges
+    void findArbitrageHopBounded();                // best cycle of at most maxHops edges per source
+    void findArbitrageAllPairs();                  // dense shortest-path matrix, updated per changed edge
+    void findArbitrageTropical();                  // best cycle of each length up to --cycle-len per node
+    void findArbitrageTopK();                      // K most profitable cycles of at most maxHops edges
+    void setMaxHops(int hops) { maxHops = hops; }
+    void setFixedPoint(bool on) { fixedPoint = on; }
+    void setFloatScreen(bool on) { floatScreen = on; }
+    void setShortCycleLength(int maxLen) { shortCycles.maxLen = maxLen; shortCycles.topology = UINT64_MAX; }
+    void setTopK(int k) { topK.k = std::max(1, k); }
     void runBenchmark();                           // benchmark mode: performance comparison
+    void runSyntheticBenchmark(int maxNodes) const; // classic vs. tropical on random graphs, same settings
+    void setRelaxKernel(RelaxKernel k) { relaxKernel = k; }
+    void setDetectionThreads(int n) { detectionThreads = std::max(1, n); }
+    void setSimdLevel(SimdLevel level);            // capped at detectSimdLevel()
+    void setContractBridges(bool on) { contractBridges = on; }
+    SimdLevel getSimdLevel() const { return simdLevel; }
+    const CertificateStats& certificateStats() const { return certStats; }
 
     // === Cycle Utilities ===
     std::vector<int> canonicalizeCycle(const std::vector<int>& cycle) const;
@@ -105,6 +847,14 @@ public:
     int findExistingBucket(double profit);
     void printBucketSummary();
 
+    // === Snapshots (GraphSnapshot.cpp) ===
+    bool saveSnapshot(const std::string& path) const;
+    bool loadSnapshot(const std::string& path);    // replaces the graph, skips warmup
+
+    // === Ingest/Detector Hand-off (GraphSnapshot.cpp) ===
+    void exportImage(GraphImage& img) const;       // writer side
+    void importImage(const GraphImage& img);       // detector side
+
     // === Diagnostics ===
     void printAllEdges();
     void printGraphSummary(int maxEdgesToShow);
@@ -113,4 +863,25 @@ public:
     void enableCSVLogging(const std::string& filename);
     void logArbitrageToCSV(const std::vector<int>& cycle, double profit);
     void disableCSVLogging();
-};
\ No newline at end of file
+};
+
+// === Graph Publisher ===
+// Lock-free triple buffer between one writer (ingest) and one reader
+// (detector). The writer fills its private back image and swaps it into the
+// shared slot; the reader swaps the shared slot with its front image only when
+// it is flagged fresh. Both swaps are single atomic exchanges, so neither
+// thread ever blocks the other and the reader always sees a complete image.
+class GraphPublisher {
+public:
+    void publish(const Graph& writer);
+    const GraphImage* acquire();                   // newest image, nullptr if none since last call
+
+private:
+    static constexpr uint8_t INDEX_MASK = 3;
+    static constexpr uint8_t FRESH = 4;
+
+    GraphImage images[3];
+    std::atomic<uint8_t> shared{1};                // index of the shared image | FRESH
+    uint8_t back = 0;                              // writer-owned
+    uint8_t front = 2;                             // reader-owned
+};
@@ -3,27 +3,415 @@
 static constexpr double PROFIT_MIN = 1.00005;
 static constexpr int MIN_CYCLE_LEN = 3;
 
-int Graph::addNode(std::string name)
+static constexpr double RELAX_EPS = 1e-9;
+static constexpr double PROFIT_MIN_LOCAL = 1.005;
+static constexpr double PROFIT_MAX_LOCAL = 10.0;
+static constexpr int HOWARD_MAX_ITERATIONS = 1000;
+static constexpr int APSP_TILE = 32;
+
+// All-pairs distances are taken over weights raised by this much per hop,
+// so a cycle is negative only if it beats PROFIT_MIN at the shortest length.
+static const double APSP_HOP_MARGIN = std::log(PROFIT_MIN) / MIN_CYCLE_LEN;
+
+int Graph::internAsset(const std::string& asset)
+{
+    auto it = assetIds.find(asset);
+    if (it != assetIds.end()) return it->second;
+
+    int id = static_cast<int>(assetNames.size());
+    assetIds.emplace(asset, id);
+    assetNames.push_back(asset);
+    return id;
+}
+
+int Graph::internExchange(const std::string& exchange)
+{
+    auto it = exchangeIds.find(exchange);
+    if (it != exchangeIds.end()) return it->second;
+
+    int id = static_cast<int>(exchangeNames.size());
+    exchangeIds.emplace(exchange, id);
+    exchangeNames.push_back(exchange);
+    if (exchange == "Cross") crossExchangeId = id;
+    return id;
+}
+
+int Graph::addNode(int assetId, int exchangeId)
+{
+    auto it = nodeIds.find(nodeKey(assetId, exchangeId));
+    if (it != nodeIds.end()) return it->second;
+
+    int id = static_cast<int>(nodeNames.size());
+    nodeIds.emplace(nodeKey(assetId, exchangeId), id);
+    nodeAsset.push_back(assetId);
+    nodeExchange.push_back(exchangeId);
+    nodeNames.push_back(exchangeId == NO_EXCHANGE
+                            ? assetNames[assetId]
+                            : assetNames[assetId] + "_" + exchangeNames[exchangeId]);
+    ++topologyVersion;
+    return id;
+}
+
+int Graph::nodeFromName(const std::string& name)
+{
+    size_t pos = name.rfind('_');
+    if (pos == std::string::npos || pos == 0 || pos + 1 == name.size())
+        return addNode(internAsset(name), NO_EXCHANGE);
+    return addNode(internAsset(name.substr(0, pos)),
+                   internExchange(name.substr(pos + 1)));
+}
+
+int Graph::addNode(const std::string& name)
+{
+    return nodeFromName(name);
+}
+
+int Graph::findEdge(int u, int v) const
+{
+    // One key per record, whichever way round it was quoted.
+    auto it = edgeIndex.find(edgeKey(std::min(u, v), std::max(u, v)));
+    if (it != edgeIndex.end()) return edges.firstEdge[it->second] + (edges.base[it->second] != u);
+
+    // Two bridged nodes of one asset: the arc belongs to the record of the
+    // one that joined later, at the other one's place among its peers.
+    if (nodeAsset[u] != nodeAsset[v] || nodeAsset[u] >= static_cast<int>(bridgeMembers.size())) return -1;
+    const auto& group = bridgeMembers[nodeAsset[u]];
+    auto iu = std::find(group.begin(), group.end(), u);
+    auto iv = std::find(group.begin(), group.end(), v);
+    if (iu == group.end() || iv == group.end()) return -1;
+    const int later = iu > iv ? u : v;
+    auto rec = edgeIndex.find(edgeKey(std::min(group[0], later), std::max(group[0], later)));
+    if (rec == edgeIndex.end()) return -1;
+    return edges.firstEdge[rec->second] + 2 * static_cast<int>(std::min(iu, iv) - group.begin()) + (later == u);
+}
+
+int Graph::insertEdge(int u, int v, double w, double p,
+                      int exch, const std::string& sym)
 {
-    if (nodeIds.find(name) == nodeIds.end()) {
-        int id = static_cast<int>(nodeNames.size());
-        nodeIds[name] = id;
-        nodeNames.push_back(name);
-        return id;
+    int idx;
+    if (isBridge(u, v, exch)) {
+        // v joins the bridge group u heads, with a pair of arcs to every
+        // node already in it.
+        if (bridgeMembers.size() < assetNames.size()) bridgeMembers.resize(assetNames.size());
+        auto& group = bridgeMembers[nodeAsset[u]];
+        if (group.empty()) group.push_back(u);
+        idx = edges.push_back(u, v, w, p, exch, sym, group.data(), static_cast<int>(group.size()));
+        group.push_back(v);
     } else {
-        return nodeIds[name];
+        idx = edges.push_back(u, v, w, p, exch, sym);
+    }
+    edgeIndex.emplace(edgeKey(std::min(u, v), std::max(u, v)), edges.record(idx));
+    ++topologyVersion;
+    certHolds = false;
+    return idx;
+}
+
+void Graph::setEdgeWeight(int e, double w, double p)
+{
+    edges.set(e, w, p);
+
+    // Every arc of the record moved.
+    const int r = edges.record(e);
+    if (priceJournal.size() >= std::max<size_t>(edges.markets(), 1024)) {
+        priceJournalStart += priceJournal.size();
+        priceJournal.clear();
+    }
+    priceJournal.push_back(r);
+    for (int side = edges.firstEdge[r]; side < edges.firstEdge[r + 1]; ++side) {
+        const double sw = edges.weight(side);
+        if (csrCurrent()) {
+            csrWeight[edgeCsrSlot[side]] = sw;
+            csrTicks[edgeCsrSlot[side]] = edges.ticks(side);
+        }
+        if (sccVersion == topologyVersion && edgeSccSlot[side] >= 0) {
+            // A contracted slot carries the cheapest of its merged edges.
+            const int k = edgeSccSlot[side];
+            int best = sccMembers[sccMemberStart[k]];
+            for (int m = sccMemberStart[k] + 1; m < sccMemberStart[k + 1]; ++m) {
+                if (edges.weight(sccMembers[m]) < edges.weight(best)) best = sccMembers[m];
+            }
+            sccEdges[k] = best;
+            sccWeight[k] = edges.weight(best);
+        }
+        if (certHolds && sw + certPotential[edges.src(side)] - certPotential[edges.dst(side)] < -RELAX_EPS)
+            certHolds = false;
+        if (static_cast<size_t>(side) < edgeChanged.size() && !edgeChanged[side]) {
+            edgeChanged[side] = 1;
+            changedEdges.push_back(side);
+        }
+    }
+}
+
+void Graph::ensureCsr()
+{
+    if (csrCurrent()) return;
+
+    const int V = static_cast<int>(nodeNames.size());
+    const int E = static_cast<int>(edges.size());
+
+    csrOffsets.assign(V + 1, 0);
+    for (int ei = 0; ei < E; ++ei) csrOffsets[edges.src(ei) + 1]++;
+    for (int n = 0; n < V; ++n) csrOffsets[n + 1] += csrOffsets[n];
+
+    csrDst.resize(E);
+    csrWeight.resize(E);
+    csrTicks.resize(E);
+    csrEdge.resize(E);
+    edgeCsrSlot.resize(E);
+
+    std::vector<int32_t> next(csrOffsets.begin(), csrOffsets.end() - 1);
+    for (int ei = 0; ei < E; ++ei) {
+        int slot = next[edges.src(ei)]++;
+        csrDst[slot] = edges.dst(ei);
+        csrWeight[slot] = edges.weight(ei);
+        csrTicks[slot] = edges.ticks(ei);
+        csrEdge[slot] = ei;
+        edgeCsrSlot[ei] = slot;
+    }
+
+    csrVersion = topologyVersion;
+}
+
+void Graph::ensureScc()
+{
+    if (sccVersion == topologyVersion && sccContracted == contractingBridges()) return;
+    ensureCsr();
+
+    const int V = static_cast<int>(nodeNames.size());
+    const int E = static_cast<int>(edges.size());
+
+    // A simple cycle of MIN_CYCLE_LEN+ edges enters and leaves each node
+    // through two different neighbours, so peel off nodes with fewer than
+    // two, e.g. a coin quoted against a single asset. Neighbours are counted
+    // in either direction.
+    std::vector<int32_t> nbrStart(V + 1, 0);
+    for (int ei = 0; ei < E; ++ei) {
+        nbrStart[edges.src(ei) + 1]++;
+        nbrStart[edges.dst(ei) + 1]++;
+    }
+    for (int n = 0; n < V; ++n) nbrStart[n + 1] += nbrStart[n];
+    std::vector<int32_t> nbr(nbrStart[V]);
+    {
+        std::vector<int32_t> next(nbrStart.begin(), nbrStart.end() - 1);
+        for (int ei = 0; ei < E; ++ei) {
+            nbr[next[edges.src(ei)]++] = edges.dst(ei);
+            nbr[next[edges.dst(ei)]++] = edges.src(ei);
+        }
+    }
+    std::vector<int32_t> degree(V, 0);
+    for (int n = 0; n < V; ++n) {
+        auto first = nbr.begin() + nbrStart[n];
+        auto last = nbr.begin() + nbrStart[n + 1];
+        std::sort(first, last);
+        last = std::unique(first, last);
+        std::fill(last, nbr.begin() + nbrStart[n + 1], -1);
+        degree[n] = static_cast<int32_t>(last - first);
+    }
+    std::vector<uint8_t> alive(V, 1);
+    std::vector<int32_t> peel;
+    for (int n = 0; n < V; ++n) {
+        if (degree[n] < 2) { alive[n] = 0; peel.push_back(n); }
+    }
+    while (!peel.empty()) {
+        const int n = peel.back();
+        peel.pop_back();
+        for (int i = nbrStart[n]; i < nbrStart[n + 1] && nbr[i] >= 0; ++i) {
+            const int m = nbr[i];
+            if (alive[m] && --degree[m] < 2) { alive[m] = 0; peel.push_back(m); }
+        }
+    }
+
+    // Tarjan over the surviving nodes, iterative.
+    std::vector<int32_t> index(V, -1), low(V, 0), comp(V, -1);
+    std::vector<uint8_t> onStack(V, 0);
+    std::vector<int32_t> stack;
+    std::vector<std::pair<int32_t, int32_t>> frames; // node, next CSR slot
+    int counter = 0;
+    int comps = 0;
+    for (int root = 0; root < V; ++root) {
+        if (!alive[root] || index[root] >= 0) continue;
+        index[root] = low[root] = counter++;
+        stack.push_back(root);
+        onStack[root] = 1;
+        frames.emplace_back(root, csrOffsets[root]);
+
+        while (!frames.empty()) {
+            const int x = frames.back().first;
+            const int slot = frames.back().second;
+            if (slot < csrOffsets[x + 1]) {
+                frames.back().second++;
+                const int y = csrDst[slot];
+                if (!alive[y]) continue;
+                if (index[y] < 0) {
+                    index[y] = low[y] = counter++;
+                    stack.push_back(y);
+                    onStack[y] = 1;
+                    frames.emplace_back(y, csrOffsets[y]);
+                } else if (onStack[y]) {
+                    low[x] = std::min(low[x], index[y]);
+                }
+                continue;
+            }
+
+            if (low[x] == index[x]) {
+                int y;
+                do {
+                    y = stack.back();
+                    stack.pop_back();
+                    onStack[y] = 0;
+                    comp[y] = comps;
+                } while (y != x);
+                ++comps;
+            }
+            frames.pop_back();
+            if (!frames.empty()) {
+                const int p = frames.back().first;
+                low[p] = std::min(low[p], low[x]);
+            }
+        }
+    }
+
+    // Keep components big enough to hold a cycle, renumbered densely.
+    std::vector<int32_t> size(comps, 0);
+    for (int n = 0; n < V; ++n) if (comp[n] >= 0) size[comp[n]]++;
+    std::vector<int32_t> remap(comps, -1);
+    int kept = 0;
+    for (int c = 0; c < comps; ++c) if (size[c] >= MIN_CYCLE_LEN) remap[c] = kept++;
+
+    sccOf.assign(V, -1);
+    for (int n = 0; n < V; ++n) {
+        if (comp[n] >= 0 && remap[comp[n]] >= 0) sccOf[n] = remap[comp[n]];
+    }
+
+    // Union the nodes Cross bridges join inside a component onto the lowest
+    // node id (a bridge is one market, so it runs both ways). Absorbed nodes
+    // keep their sccOf but stop being sources.
+    const bool contract = contractingBridges();
+    bridgeRep.resize(V);
+    for (int n = 0; n < V; ++n) bridgeRep[n] = n;
+    if (contract) {
+        auto find = [&](int n) {
+            while (bridgeRep[n] != n) n = bridgeRep[n] = bridgeRep[bridgeRep[n]];
+            return n;
+        };
+        for (int ei = 0; ei < E; ++ei) {
+            const int u = edges.src(ei);
+            const int v = edges.dst(ei);
+            if (edges.exchange(ei) != crossExchangeId || sccOf[u] < 0 || sccOf[u] != sccOf[v]) continue;
+            const int ru = find(u);
+            const int rv = find(v);
+            if (ru != rv) bridgeRep[std::max(ru, rv)] = std::min(ru, rv);
+        }
+        for (int n = 0; n < V; ++n) bridgeRep[n] = find(n);
+    }
+
+    cyclicNodes.clear();
+    sccNodeStart.assign(kept + 1, 0);
+    for (int n = 0; n < V; ++n) {
+        if (sccOf[n] < 0 || bridgeRep[n] != n) continue;
+        cyclicNodes.push_back(n);
+        sccNodeStart[sccOf[n] + 1]++;
+    }
+    for (int c = 0; c < kept; ++c) sccNodeStart[c + 1] += sccNodeStart[c];
+    sccNodes.resize(cyclicNodes.size());
+    {
+        std::vector<int32_t> next(sccNodeStart.begin(), sccNodeStart.end() - 1);
+        for (int n : cyclicNodes) sccNodes[next[sccOf[n]]++] = n;
+    }
+
+    // Members of each representative, ascending (just the node itself
+    // unless contracting).
+    std::vector<int32_t> memberStart(V + 1, 0);
+    for (int n = 0; n < V; ++n) if (sccOf[n] >= 0) memberStart[bridgeRep[n] + 1]++;
+    for (int n = 0; n < V; ++n) memberStart[n + 1] += memberStart[n];
+    std::vector<int32_t> members(memberStart[V]);
+    {
+        std::vector<int32_t> next(memberStart.begin(), memberStart.end() - 1);
+        for (int n = 0; n < V; ++n) if (sccOf[n] >= 0) members[next[bridgeRep[n]]++] = n;
+    }
+
+    // Internal edges grouped by component, then by source in sccNodes
+    // order, so each member's out-edges form one run (CSR order within).
+    // Edges landing on a representative already reached share its slot,
+    // which keeps the cheapest; without contraction every slot has one.
+    sccEdgeStart.assign(kept + 1, 0);
+    sccOutStart.assign(sccNodes.size() + 1, 0);
+    sccEdges.clear();
+    sccDst.clear();
+    sccWeight.clear();
+    edgeSccSlot.assign(E, -1);
+    std::vector<int32_t> slotOf(V, -1);
+    std::vector<std::pair<int32_t, int32_t>> merged; // slot, edge id
+    for (int c = 0; c < kept; ++c) {
+        for (int i = sccNodeStart[c]; i < sccNodeStart[c + 1]; ++i) {
+            const int x = sccNodes[i];
+            sccOutStart[i] = static_cast<int32_t>(sccEdges.size());
+            for (int m = memberStart[x]; m < memberStart[x + 1]; ++m) {
+                const int from = members[m];
+                for (int slot = csrOffsets[from]; slot < csrOffsets[from + 1]; ++slot) {
+                    const int y = csrDst[slot];
+                    if (sccOf[y] != c || bridgeRep[y] == x) continue;
+                    const int ry = bridgeRep[y];
+                    int k = slotOf[ry];
+                    if (k < sccOutStart[i]) {
+                        k = slotOf[ry] = static_cast<int32_t>(sccEdges.size());
+                        sccEdges.push_back(csrEdge[slot]);
+                        sccDst.push_back(ry);
+                        sccWeight.push_back(csrWeight[slot]);
+                    } else if (csrWeight[slot] < sccWeight[k]) {
+                        sccEdges[k] = csrEdge[slot];
+                        sccWeight[k] = csrWeight[slot];
+                    }
+                    edgeSccSlot[csrEdge[slot]] = k;
+                    merged.emplace_back(k, csrEdge[slot]);
+                }
+            }
+        }
+        sccEdgeStart[c + 1] = static_cast<int32_t>(sccEdges.size());
     }
+    sccOutStart[sccNodes.size()] = static_cast<int32_t>(sccEdges.size());
+
+    sccMemberStart.assign(sccEdges.size() + 1, 0);
+    for (const auto& sm : merged) sccMemberStart[sm.first + 1]++;
+    for (size_t k = 0; k < sccEdges.size(); ++k) sccMemberStart[k + 1] += sccMemberStart[k];
+    sccMembers.resize(merged.size());
+    {
+        std::vector<int32_t> next(sccMemberStart.begin(), sccMemberStart.end() - 1);
+        for (const auto& sm : merged) sccMembers[next[sm.first]++] = sm.second;
+    }
+
+    sccVersion = topologyVersion;
+    sccContracted = contract;
+}
+
+void Graph::printSccStats(const char* prefix) const
+{
+    if (sccVersion == UINT64_MAX) return;
+
+    std::cout << prefix << "[SCC] " << sccNodeStart.size() - 1 << " cyclic component(s) covering "
+              << cyclicNodes.size() << "/" << sccOf.size() << " nodes, "
+              << sccEdges.size() << "/" << edgeSccSlot.size() << " edges"
+              << (sccContracted ? " (Cross bridges contracted)" : "") << "\n";
 }
 
-double Graph::addOrUpdateEdge(std::string s, std::string d, double p,
+double Graph::addOrUpdateEdge(const std::string& s, const std::string& d, double p,
                               const std::string& exch,
                               const std::string& sym)
 {
-    if (!std::isfinite(p) || p <= 0.0) {
+    int exchId = exch.empty() ? NO_EXCHANGE : internExchange(exch);
+    return updateEdge(nodeFromName(s), nodeFromName(d), p, exchId, sym);
+}
+
+double Graph::updateEdge(int u, int v, double p, int exch, const std::string& sym)
+{
+    // A node's out-edges must lead to distinct nodes (the vector passes rely
+    // on it), and a self-loop would be a permanent negative cycle.
+    if (u == v || !std::isfinite(p) || p <= 0.0) {
         return std::numeric_limits<double>::quiet_NaN();
     }
     
-    if (exch == "Cross") {
+    const bool isCross = (exch != NO_EXCHANGE && exch == crossExchangeId);
+    if (isCross) {
         if (std::fabs(p - 1.0) > 1e-9) {
             return std::numeric_limits<double>::quiet_NaN();
         }
@@ -33,82 +421,218 @@ double Graph::addOrUpdateEdge(std::string s, std::string d, double p,
         }
     }
 
-    int u = addNode(s);
-    int v = addNode(d);
-
     double w = -std::log(p);
     if (!std::isfinite(w)) {
         return std::numeric_limits<double>::quiet_NaN();
     }
 
-    for (auto& e : edges) {
-        if (e.source == u && e.destination == v) {
-            e.weight = w;
-            e.price  = p;
-            if (!exch.empty()) e.exchange = exch;
-            if (!sym.empty())  e.symbol   = sym;
-            return w;
+    // A tick for the inverse side updates the same market.
+    auto upsert = [&](int from, int to) {
+        int e = findEdge(from, to);
+        if (e >= 0) {
+            setEdgeWeight(e, w, p);
+            if (exch != NO_EXCHANGE) edges.marketExchange[edges.record(e)] = exch;
+            if (edges.marketSymbol[edges.record(e)].empty() && !sym.empty()) edges.marketSymbol[edges.record(e)] = sym;
+        } else {
+            insertEdge(from, to, w, p, exch, sym);
         }
-    }
+    };
 
-    Edge e{u, v, w, p, exch, sym};
-    edges.push_back(e);
-    
-    if (exch != "Cross" && p > 0.0) {
-        double p_inv = 1.0 / p;
-        double w_inv = -std::log(p_inv);
-        
-        if (std::isfinite(w_inv)) {
-            bool inverseExists = false;
-            for (auto& edge : edges) {
-                if (edge.source == v && edge.destination == u) {
-                    edge.weight = w_inv;
-                    edge.price = p_inv;
-                    if (!exch.empty()) edge.exchange = exch;
-                    if (!sym.empty()) edge.symbol = sym + "_INV";
-                    inverseExists = true;
-                    break;
-                }
-            }
-            
-            if (!inverseExists) {
-                Edge e_inv{v, u, w_inv, p_inv, exch, sym + "_INV"};
-                edges.push_back(e_inv);
-            }
+    if (isBridge(u, v, exch)) {
+        // Each bridged node joins its asset's group once, through a record
+        // from the group's first node that also carries its arcs to every
+        // other member, so N exchanges cost N-1 records and this bridge
+        // stays one direct hop.
+        if (bridgeMembers.size() < assetNames.size()) bridgeMembers.resize(assetNames.size());
+        auto& group = bridgeMembers[nodeAsset[u]];
+        if (group.empty()) group.push_back(u);
+        for (int x : {u, v}) {
+            if (std::find(group.begin(), group.end(), x) == group.end())
+                insertEdge(group[0], x, 0.0, 1.0, exch, sym);
         }
+        setEdgeWeight(findEdge(u, v), w, p);
+        return w;
     }
+    upsert(u, v);
     
     return w;
 }
 
+int Graph::findNode(const std::string& asset, int exchangeId) const
+{
+    auto a = assetIds.find(asset);
+    if (a == assetIds.end()) return -1;
+    auto it = nodeIds.find(nodeKey(a->second, exchangeId));
+    return it == nodeIds.end() ? -1 : it->second;
+}
+
+int Graph::findNodeByName(const std::string& name) const
+{
+    size_t pos = name.rfind('_');
+    if (pos == std::string::npos || pos == 0 || pos + 1 == name.size())
+        return findNode(name, NO_EXCHANGE);
+    auto ex = exchangeIds.find(name.substr(pos + 1));
+    if (ex == exchangeIds.end()) return findNode(name, NO_EXCHANGE);
+    return findNode(name.substr(0, pos), ex->second);
+}
+
+EdgeHandle Graph::resolveNodes(int u, int v, int exch) const
+{
+    EdgeHandle h;
+    if (u < 0 || v < 0) return h;
+    h.cross = (exch != NO_EXCHANGE && exch == crossExchangeId);
+    h.forward = findEdge(u, v);
+    return h;
+}
+
+EdgeHandle Graph::resolve(const std::string& base,
+                          const std::string& quote,
+                          const std::string& exchange) const
+{
+    auto ex = exchangeIds.find(exchange);
+    if (ex == exchangeIds.end()) return EdgeHandle{};
+
+    if (ex->second == crossExchangeId)
+        return resolveNodes(findNodeByName(base), findNodeByName(quote), ex->second);
+    return resolveNodes(findNode(base, ex->second), findNode(quote, ex->second), ex->second);
+}
+
+double Graph::updatePrice(const EdgeHandle& h, double p)
+{
+    if (!h.valid() || !std::isfinite(p) || p <= 0.0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (h.cross) {
+        if (std::fabs(p - 1.0) > 1e-9) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+    } else if (p < 1e-8 || p > 1e8) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    double w = -std::log(p);
+    if (!std::isfinite(w)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    setEdgeWeight(h.forward, w, p);
+    return w;
+}
+
 void Graph::printAllEdges() {
-    for (auto& e : edges) {
-        std::cout << nodeNames[e.source] << " -> " << nodeNames[e.destination]
-                  << " has weight = " << e.weight << std::endl;
+    for (size_t ei = 0; ei < edges.size(); ++ei) {
+        std::cout << nodeNames[edges.src(ei)] << " -> " << nodeNames[edges.dst(ei)]
+                  << " has weight = " << edges.weight(ei) << std::endl;
     }
 }
 
-void Graph::processMessage(std::string msg) {
+// Pulls the handful of top-level fields processMessage needs straight out of
+// the token stream, without building a json DOM for every tick.
+struct TickReader : nlohmann::json_sax<json> {
+    enum Field { NONE, BASE, QUOTE, EXCHANGE, SYMBOL, PRICE };
+
+    explicit TickReader(std::string& b, std::string& q, std::string& e,
+                        std::string& s, double& p, bool& hp)
+        : base(b), quote(q), exchange(e), symbol(s), price(p), hasPrice(hp) {}
+
+    std::string& base;
+    std::string& quote;
+    std::string& exchange;
+    std::string& symbol;
+    double& price;
+    bool& hasPrice;
+    int depth = 0;
+    Field field = NONE;
+    bool hasBase = false;
+    bool hasQuote = false;
+
+    bool key(string_t& k) override {
+        field = NONE;
+        if (depth != 1) return true;
+        if (k == "base") field = BASE;
+        else if (k == "quote") field = QUOTE;
+        else if (k == "exchange") field = EXCHANGE;
+        else if (k == "symbol") field = SYMBOL;
+        else if (k == "price") field = PRICE;
+        return true;
+    }
+    bool string(string_t& val) override {
+        switch (field) {
+            case BASE: base.assign(val); hasBase = true; break;
+            case QUOTE: quote.assign(val); hasQuote = true; break;
+            case EXCHANGE: exchange.assign(val); break;
+            case SYMBOL: symbol.assign(val); break;
+            default: break;
+        }
+        field = NONE;
+        return true;
+    }
+    bool number(double val) {
+        if (field == PRICE) { price = val; hasPrice = true; }
+        field = NONE;
+        return true;
+    }
+    bool number_float(number_float_t val, const string_t&) override { return number(val); }
+    bool number_integer(number_integer_t val) override { return number(static_cast<double>(val)); }
+    bool number_unsigned(number_unsigned_t val) override { return number(static_cast<double>(val)); }
+    bool null() override { field = NONE; return true; }
+    bool boolean(bool) override { field = NONE; return true; }
+    bool binary(binary_t&) override { field = NONE; return true; }
+    bool start_object(std::size_t) override { ++depth; field = NONE; return true; }
+    bool end_object() override { --depth; return true; }
+    bool start_array(std::size_t) override { ++depth; field = NONE; return true; }
+    bool end_array() override { --depth; return true; }
+    bool parse_error(std::size_t, const std::string&,
+                     const nlohmann::detail::exception& ex) override {
+        throw std::runtime_error(ex.what());
+    }
+};
+
+void Graph::processMessage(const std::string& msg) {
     try {
-        auto j = json::parse(msg);
-        std::string base = j["base"];
-        std::string quote = j["quote"];
-        std::string exchange = j.value("exchange", "");
-        std::string symbol = j.value("symbol", "");
-        double price = j["price"];
-
-        std::string source;
-        std::string destination;
+        tick.exchange.clear();
+        tick.symbol.clear();
+        tick.hasPrice = false;
+
+        TickReader reader(tick.base, tick.quote, tick.exchange, tick.symbol,
+                          tick.price, tick.hasPrice);
+        json::sax_parse(msg, &reader);
+        if (!reader.hasBase || !reader.hasQuote || !tick.hasPrice) {
+            throw std::runtime_error("message missing base, quote or price");
+        }
+
+        int exchId = tick.exchange.empty() ? NO_EXCHANGE : internExchange(tick.exchange);
+
+        const bool isCross = (exchId != NO_EXCHANGE && exchId == crossExchangeId);
+
+        if (!isCross && exchId != NO_EXCHANGE && !tick.symbol.empty() &&
+            exchId < (int)priceHandles.size()) {
+            auto it = priceHandles[exchId].find(tick.symbol);
+            if (it != priceHandles[exchId].end()) {
+                updatePrice(it->second, tick.price);
+                return;
+            }
+        }
+
+        int source;
+        int destination;
         
-        if (exchange == "Cross") {
-            source = base;
-            destination = quote;
+        if (isCross) {
+            source = nodeFromName(tick.base);
+            destination = nodeFromName(tick.quote);
         } else {
-            source = base + "_" + exchange;
-            destination = quote + "_" + exchange;
+            source = addNode(internAsset(tick.base), exchId);
+            destination = addNode(internAsset(tick.quote), exchId);
         }
 
-        addOrUpdateEdge(source, destination, price, exchange, symbol);
+        updateEdge(source, destination, tick.price, exchId, tick.symbol);
+
+        if (!isCross && exchId != NO_EXCHANGE && !tick.symbol.empty()) {
+            EdgeHandle h = resolveNodes(source, destination, exchId);
+            if (h.valid()) {
+                if (exchId >= (int)priceHandles.size()) priceHandles.resize(exchId + 1);
+                priceHandles[exchId].emplace(tick.symbol, h);
+            }
+        }
         
     } catch (std::exception& e) {
         std::cerr << "[Graph] processMessage error: " << e.what() << std::endl;
@@ -185,35 +709,62 @@ int Graph::findExistingBucket(double profit) {
     return -1;
 }
 
-void Graph::findArbitrage() {
-    const int V = static_cast<int>(nodeNames.size());
-    if (V == 0) return;
+bool Graph::screenCycle(const std::vector<int>& cycle,
+                        const std::vector<int>& cycleEdgeIdx,
+                        double& profit) const
+{
+    profit = 1.0;
+    for (int pe : cycleEdgeIdx) {
+        double p = edges.price(pe);
+        if (!std::isfinite(p) || p <= 0.0) {
+            profit = std::numeric_limits<double>::quiet_NaN();
+            break;
+        }
+        profit *= p;
+        if (!std::isfinite(profit)) break;
+    }
 
-    using clock_wall = std::chrono::system_clock;
+    if (!std::isfinite(profit)) return false;
+    if (profit <= 0.0 || profit > PROFIT_MAX_LOCAL) return false;
+    if ((int)cycle.size() < MIN_CYCLE_LEN) return false;
+    if (profit < PROFIT_MIN_LOCAL) return false;
+    return true;
+}
 
-    static bool warmupInitialized = false;
-    static std::time_t startEpoch = 0;
-    static std::time_t lastWarnedSec = -1;
-    const int WARMUP_SECONDS = 3;
+bool Graph::acceptCycle(const std::vector<int>& cycle,
+                        const std::vector<int>& cycleEdgeIdx,
+                        double& profit)
+{
+    if (!screenCycle(cycle, cycleEdgeIdx, profit)) return false;
 
-    std::time_t nowEpoch = std::chrono::system_clock::to_time_t(clock_wall::now());
-    if (!warmupInitialized) {
-        warmupInitialized = true;
-        startEpoch = nowEpoch;
-    }
-    if (nowEpoch - startEpoch < WARMUP_SECONDS) {
-        if (nowEpoch != lastWarnedSec) {
-            std::tm tm = *std::localtime(&nowEpoch);
-            std::cout << "[warm-up] Ignoring arbitrage for another "
-                      << (WARMUP_SECONDS - (nowEpoch - startEpoch))
-                      << "s @ " << std::put_time(&tm, "%H:%M:%S") << std::endl;
-            lastWarnedSec = nowEpoch;
-        }
-        return;
+    std::string sig = canonicalSignature(cycle, profit);
+    return !isDuplicateCycle(sig);
+}
+
+void Graph::announceCycle(const char* prefix, const DetectedCycle& fc)
+{
+    using clock_wall = std::chrono::system_clock;
+
+    std::ostringstream path;
+    for (int nidx : fc.nodes) {
+        path << nodeNames[nidx] << " -> ";
     }
+    path << nodeNames[fc.nodes.front()];
 
-    static std::time_t lastSecond = 0;
-    static int foundThisSecond = 0;
+    std::time_t ts = clock_wall::to_time_t(clock_wall::now());
+    std::tm ts_tm = *std::localtime(&ts);
+    
+    std::ostringstream pss;
+    pss << std::fixed << std::setprecision(10) << fc.profit;
+
+    std::cout << prefix << "[" << std::put_time(&ts_tm, "%Y-%m-%d %H:%M:%S") << "] "
+              << "[!] Arbitrage found! Profit = " << pss.str()
+              << "x | Path: " << path.str() << "\n";
+}
+
+bool Graph::rollSecondSummary(const char* prefix, std::time_t& lastSecond, int& foundThisSecond)
+{
+    using clock_wall = std::chrono::system_clock;
 
     std::time_t secNow = clock_wall::to_time_t(clock_wall::now());
     if (lastSecond == 0) lastSecond = secNow;
@@ -221,126 +772,1865 @@ void Graph::findArbitrage() {
     if (secNow != lastSecond) {
         if (foundThisSecond == 0) {
             std::tm t = *std::localtime(&lastSecond);
-            std::cout << "--- No arbitrage between "
+            std::cout << prefix << "--- No arbitrage between "
                       << std::put_time(&t, "%H:%M:%S") << " and "
                       << std::put_time(std::localtime(&secNow), "%H:%M:%S")
                       << " ---\n";
         } else {
             std::tm t = *std::localtime(&lastSecond);
-            std::cout << "=== Arbitrages found @ " << std::put_time(&t, "%H:%M:%S")
+            std::cout << prefix << "=== Arbitrages found @ " << std::put_time(&t, "%H:%M:%S")
                       << " => " << foundThisSecond << " ===\n\n";
         }
-        foundThisSecond = 0;
-        lastSecond = secNow;
+        foundThisSecond = 0;
+        lastSecond = secNow;
+        return true;
+    }
+    return false;
+}
+
+void Graph::printCertificateStats(const char* prefix) const
+{
+    if (certStats.ticks == 0) return;
+
+    std::ostringstream pct;
+    pct << std::fixed << std::setprecision(1) << 100.0 * certStats.skipped / certStats.ticks;
+
+    std::cout << prefix << "[Certificate] " << certStats.skipped << " of " << certStats.ticks
+              << " ticks skipped (" << pct.str() << "%)\n";
+}
+
+bool Graph::certificateSkip()
+{
+    ++certStats.ticks;
+    if (!certHolds) return false;
+    ++certStats.skipped;
+    return true;
+}
+
+void Graph::rebuildCertificate()
+{
+    const int V = static_cast<int>(nodeNames.size());
+    ensureCsr();
+
+    // Bellman-Ford from an implicit source joined to every node at weight 0.
+    // Converges within V passes unless a negative cycle exists.
+    // Every node starts lowered (to 0) before pass 0; later passes only
+    // scan out of nodes lowered since their previous scan.
+    certPotential.assign(V, 0.0);
+    std::vector<int32_t> lastPass(V, -1);
+    bool changed = true;
+    for (int pass = 0; pass < V && changed; ++pass) {
+        changed = false;
+        for (int x = 0; x < V; ++x) {
+            if (lastPass[x] < pass - 1) continue;
+            const double px = certPotential[x];
+            for (int s = csrOffsets[x]; s < csrOffsets[x + 1]; ++s) {
+                const double cand = px + csrWeight[s];
+                if (cand < certPotential[csrDst[s]] - RELAX_EPS) {
+                    certPotential[csrDst[s]] = cand;
+                    lastPass[csrDst[s]] = pass;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    certHolds = !changed;
+}
+
+void Graph::printScreenStats(const char* prefix) const
+{
+    if (screen.scans == 0) return;
+
+    std::ostringstream pct;
+    pct << std::fixed << std::setprecision(1) << 100.0 * screen.clearedScans / screen.scans;
+
+    std::cout << prefix << "[Screen] " << screen.clearedScans << " of " << screen.scans
+              << " component scans cleared in float32 (" << pct.str() << "%)\n";
+}
+
+bool Graph::screenComponent(int comp)
+{
+    static const double logMin = std::log(PROFIT_MIN_LOCAL);
+    auto& sc = screen;
+    const int first = sccNodeStart[comp];
+    const int n = sccNodeStart[comp + 1] - first;
+    // Seven eighths of the budget go to the raise, the rest to rounding.
+    const double delta = 0.875 * logMin / n;
+
+    for (int i = first; i < first + n; ++i) {
+        const int u = sccNodes[i];
+        sc.dist[u] = 0.0f;
+        sc.lastPass[u] = -1;
+        for (int k = sccOutStart[i]; k < sccOutStart[i + 1]; ++k)
+            sc.weight[k] = static_cast<float>(sccWeight[k] + sc.potential[u] - sc.potential[sccDst[k]] + delta);
+    }
+
+    ScreenSpan span;
+    span.nodes = sccNodes.data() + first;
+    span.nodeCount = n;
+    span.outStart = sccOutStart.data() + first;
+    span.dst = sccDst.data();
+    span.weight = sc.weight.data();
+    span.dist = sc.dist.data();
+    span.lastPass = sc.lastPass.data();
+
+    // Every shortest path from the implicit source has at most n - 1 edges,
+    // so a pass that lowers nothing comes within n unless float32 sees a
+    // negative cycle.
+    bool settled = false;
+    for (int pass = 0; pass < n && !settled; ++pass) {
+        bool lowered = false;
+        screenPass(span, pass, lowered);
+        settled = !lowered;
+    }
+    if (!settled) return false;
+
+    // Settled means d[v] <= fl(d[u] + f) on every edge, and the float sum
+    // is within 2^-24 |d[u] + f| of the exact one; f itself is |r - f| off
+    // the double re-based weight r. Around a cycle of len edges the d and
+    // potential terms cancel, so its double weight is at least
+    // -len * (delta + err) with err the largest of those per-edge errors.
+    // RELAX_EPS covers the rounding of r and of the price product.
+    const double unit = std::ldexp(1.0, -24);
+    double err = 0.0;
+    for (int i = first; i < first + n; ++i) {
+        const int u = sccNodes[i];
+        for (int k = sccOutStart[i]; k < sccOutStart[i + 1]; ++k) {
+            const double r = sccWeight[k] + sc.potential[u] - sc.potential[sccDst[k]] + delta;
+            const double f = sc.weight[k];
+            err = std::max(err, std::fabs(r - f) + unit * std::fabs(sc.dist[u] + f));
+        }
+    }
+    return n * (delta + err) + RELAX_EPS < logMin;
+}
+
+void Graph::screenComponents()
+{
+    const int V = static_cast<int>(nodeNames.size());
+    const int C = static_cast<int>(sccNodeStart.size()) - 1;
+    auto& sc = screen;
+
+    sc.cleared.assign(std::max(C, 0), 0);
+    if (!floatScreen || sccContracted) return;
+
+    treePotential(sc.potential, sc.queue);
+    sc.weight.resize(sccDst.size());
+    sc.dist.resize(V);
+    sc.lastPass.resize(V);
+    for (int c = 0; c < C; ++c) {
+        ++sc.scans;
+        if (!screenComponent(c)) continue;
+        sc.cleared[c] = 1;
+        ++sc.clearedScans;
+    }
+}
+
+RelaxSpan Graph::spanFor(int comp) const
+{
+    // Inside one component: its own edges, one pass per member node.
+    // Otherwise the whole CSR (kept current by runKernel's callers).
+    RelaxSpan span;
+    if (comp >= 0) {
+        const int first = sccNodeStart[comp];
+        span.nodes = sccNodes.data() + first;
+        span.nodeCount = sccNodeStart[comp + 1] - first;
+        span.outStart = sccOutStart.data() + first;
+        span.dst = sccDst.data();
+        span.weight = sccWeight.data();
+        span.ids = sccEdges.data();
+    } else {
+        span.nodeCount = static_cast<int>(nodeNames.size());
+        span.outStart = csrOffsets.data();
+        span.dst = csrDst.data();
+        span.weight = csrWeight.data();
+        span.ids = csrEdge.data();
+    }
+    span.eps = RELAX_EPS;
+    return span;
+}
+
+Graph::KernelWork Graph::relaxFromSource(int start,
+                                         std::vector<double>& dist,
+                                         std::vector<int>& parent,
+                                         std::vector<int>& parentEdge,
+                                         std::vector<int32_t>& lastPass,
+                                         int comp) const
+{
+    const int V = static_cast<int>(nodeNames.size());
+    const double INF = std::numeric_limits<double>::infinity();
+
+    // lastPass -2: never reached; -1: the start, lowered before pass 0.
+    // Gains under RELAX_EPS are ignored: a u -> v -> u round trip priced at
+    // p and 1/p sums to a rounding-level negative weight that would
+    // otherwise keep every pass busy.
+    dist.assign(V, INF);
+    parent.assign(V, -1);
+    parentEdge.assign(V, -1);
+    lastPass.assign(V, -2);
+    dist[start] = 0.0;
+    lastPass[start] = -1;
+    if (start == superSourceId) {
+        // Its implicit links reach every node at 0 before the first pass.
+        std::fill(dist.begin(), dist.end(), 0.0);
+        std::fill(parent.begin(), parent.end(), start);
+        std::fill(lastPass.begin(), lastPass.end(), -1);
+        parent[start] = -1;
+    }
+
+    RelaxSpan span = spanFor(comp);
+    span.dist = dist.data();
+    span.parent = parent.data();
+    span.parentEdge = parentEdge.data();
+    span.lastPass = lastPass.data();
+
+    KernelWork work;
+    work.passBound = comp >= 0 ? sccNodeStart[comp + 1] - sccNodeStart[comp] - 1 : V - 1;
+
+    for (int i = 0; i < work.passBound; ++i) {
+        bool lowered = false;
+        work.edges += relaxPass(span, i, lowered);
+        ++work.passes;
+        if (!lowered) break;
+    }
+    return work;
+}
+
+void Graph::collectCycles(const std::vector<double>& dist,
+                          std::vector<int>& parent,
+                          std::vector<int>& parentEdge,
+                          std::vector<DetectedCycle>& found,
+                          bool dedup,
+                          int comp)
+{
+    const int V = static_cast<int>(nodeNames.size());
+    const double INF = std::numeric_limits<double>::infinity();
+
+    // Outside a component's own edges dist is unreachable, so only scan those.
+    // There dist and parent are kept per representative (see ensureScc()).
+    const int32_t* ids = comp >= 0 ? sccEdges.data() + sccEdgeStart[comp] : nullptr;
+    const int count = comp >= 0 ? sccEdgeStart[comp + 1] - sccEdgeStart[comp]
+                                : static_cast<int>(edges.size());
+    const bool contracted = comp >= 0 && sccContracted;
+    auto rep = [&](int n) { return contracted ? bridgeRep[n] : n; };
+
+    for (int k = 0; k < count; ++k) {
+        const int ei = ids ? ids[k] : k;
+        const int from = rep(edges.src(ei));
+        const int to = rep(edges.dst(ei));
+
+        if (dist[from] != INF &&
+            dist[from] + edges.weight(ei) < dist[to] - RELAX_EPS) {
+            
+            parent[to] = from;
+            parentEdge[to] = ei;
+            
+            int v = to;
+            for (int i = 0; i < V; ++i) {
+                v = parent[v];
+            }
+
+            std::vector<int> cycle;
+            int cur = v;
+            do {
+                cycle.push_back(cur);
+                cur = parent[cur];
+            } while (cur != v && cur != -1);
+            
+            if (cycle.empty()) continue;
+            std::reverse(cycle.begin(), cycle.end());
+
+            const int n = (int)cycle.size();
+            std::vector<int> cycleEdgeIdx;
+            cycleEdgeIdx.reserve(n);
+            bool edgesOk = true;
+            
+            for (int i = 0; i < n; ++i) {
+                int toNode = cycle[(i + 1) % n];
+                int pe = parentEdge[toNode];
+                
+                if (pe < 0 || 
+                    rep(edges.src(pe)) != cycle[i] || 
+                    rep(edges.dst(pe)) != toNode) {
+                    edgesOk = false;
+                    break;
+                }
+                cycleEdgeIdx.push_back(pe);
+            }
+            
+            if (!edgesOk) continue;
+            if (contracted && !expandBridges(cycle, cycleEdgeIdx)) continue;
+
+            double profit = 0.0;
+            if (!(dedup ? acceptCycle(cycle, cycleEdgeIdx, profit)
+                        : screenCycle(cycle, cycleEdgeIdx, profit))) continue;
+
+            found.push_back(DetectedCycle{std::move(cycle), profit});
+        }
+    }
+}
+
+bool Graph::expandBridges(std::vector<int>& cycle, std::vector<int>& cycleEdgeIdx) const
+{
+    // Walk the real edges in order; wherever one ends on another node of
+    // the group the next leaves from, cross over on the shortest run of
+    // Cross bridges (one hop when the group is fully bridged).
+    const int n = static_cast<int>(cycleEdgeIdx.size());
+    std::vector<int> nodes;
+    std::vector<int> path;
+    for (int i = 0; i < n; ++i) {
+        const int e = cycleEdgeIdx[i];
+        const int from = edges.dst(e);
+        const int to = edges.src(cycleEdgeIdx[(i + 1) % n]);
+        nodes.push_back(edges.src(e));
+        path.push_back(e);
+        if (from == to) continue;
+
+        const int direct = findEdge(from, to);
+        if (direct >= 0 && edges.exchange(direct) == crossExchangeId) {
+            nodes.push_back(from);
+            path.push_back(direct);
+            continue;
+        }
+
+        std::unordered_map<int, int> via{{from, -1}};  // node -> bridge that reached it
+        std::deque<int> queue{from};
+        while (!queue.empty() && !via.count(to)) {
+            const int x = queue.front();
+            queue.pop_front();
+            for (int s = csrOffsets[x]; s < csrOffsets[x + 1]; ++s) {
+                const int y = csrDst[s];
+                if (edges.exchange(csrEdge[s]) != crossExchangeId ||
+                    bridgeRep[y] != bridgeRep[from] || via.count(y)) continue;
+                via.emplace(y, csrEdge[s]);
+                queue.push_back(y);
+            }
+        }
+        if (!via.count(to)) return false;
+
+        std::vector<int> hops;
+        for (int y = to; y != from; y = edges.src(via[y])) hops.push_back(via[y]);
+        for (auto it = hops.rbegin(); it != hops.rend(); ++it) {
+            nodes.push_back(edges.src(*it));
+            path.push_back(*it);
+        }
+    }
+    cycle = std::move(nodes);
+    cycleEdgeIdx = std::move(path);
+    return true;
+}
+
+long long Graph::relaxQueueFromSource(int start,
+                                      std::vector<double>& dist,
+                                      std::vector<int>& parent,
+                                      std::vector<int>& parentEdge,
+                                      std::vector<DetectedCycle>& found,
+                                      KernelScratch& q,
+                                      bool dedup,
+                                      int comp)
+{
+    const int V = static_cast<int>(nodeNames.size());
+    const double INF = std::numeric_limits<double>::infinity();
+
+    dist.assign(V, INF);
+    parent.assign(V, -1);
+    parentEdge.assign(V, -1);
+
+    auto& next = q.next;
+    auto& prev = q.prev;
+    auto& depth = q.depth;
+    auto& inTree = q.inTree;
+    auto& inQueue = q.inQueue;
+    auto& queue = q.queue;
+    next.resize(V);
+    prev.resize(V);
+    depth.resize(V);
+    inTree.assign(V, 0);
+    inQueue.assign(V, 0);
+    if (q.disabled.size() < csrDst.size()) q.disabled.resize(csrDst.size(), 0);
+
+    dist[start] = 0.0;
+    next[start] = prev[start] = start;
+    depth[start] = 0;
+    inTree[start] = 1;
+    queue.push_back(start);
+    inQueue[start] = 1;
+    if (start == superSourceId) {
+        // Its implicit links make every node a child at 0, queued in order.
+        for (int y = 0; y < V; ++y) {
+            if (y == start) continue;
+            dist[y] = 0.0;
+            parent[y] = start;
+            next[y] = start;
+            prev[y] = prev[start];
+            next[prev[start]] = y;
+            prev[start] = y;
+            depth[y] = 1;
+            inTree[y] = 1;
+            queue.push_back(y);
+            inQueue[y] = 1;
+        }
+    }
+
+    long long scanned = 0;
+    while (!queue.empty()) {
+        const int x = queue.front();
+        queue.pop_front();
+        inQueue[x] = 0;
+        if (!inTree[x]) continue;                  // detached: an ancestor improved since
+
+        for (int s = csrOffsets[x]; s < csrOffsets[x + 1]; ++s) {
+            ++scanned;
+            if (q.disabled[s]) continue;
+
+            const int y = csrDst[s];
+            if (comp >= 0 && sccOf[y] != comp) continue;
+            const double cand = dist[x] + csrWeight[s];
+            if (!(cand < dist[y] - RELAX_EPS)) continue;
+
+            if (inTree[y]) {
+                // y's subtree is the run of nodes after y that sit deeper.
+                bool closes = (x == y);
+                int last = y;
+                for (int z = next[y]; z != y && depth[z] > depth[y]; z = next[z]) {
+                    if (z == x) closes = true;
+                    last = z;
+                }
+
+                if (closes) {
+                    // Tree path y -> ... -> x plus x -> y.
+                    std::vector<int> cycle;
+                    std::vector<int> cycleEdgeIdx;
+                    for (int z = x; ; z = parent[z]) {
+                        cycle.push_back(z);
+                        if (z == y) break;
+                        cycleEdgeIdx.push_back(parentEdge[z]);
+                    }
+                    std::reverse(cycle.begin(), cycle.end());
+                    std::reverse(cycleEdgeIdx.begin(), cycleEdgeIdx.end());
+                    cycleEdgeIdx.push_back(csrEdge[s]);
+
+                    // The first cycle that passes ends the run, as one
+                    // extraction pass ends a Bellman-Ford run; one that
+                    // fails only disables its closing edge.
+                    double profit = 0.0;
+                    if (dedup ? acceptCycle(cycle, cycleEdgeIdx, profit)
+                              : screenCycle(cycle, cycleEdgeIdx, profit)) {
+                        found.push_back(DetectedCycle{std::move(cycle), profit});
+                        queue.clear();
+                        break;
+                    }
+
+                    q.disabled[s] = 1;
+                    q.disabledSlots.push_back(s);
+                    continue;
+                }
+
+                for (int z = next[y]; z != next[last]; z = next[z]) inTree[z] = 0;
+                next[prev[y]] = next[last];
+                prev[next[last]] = prev[y];
+            }
+
+            dist[y] = cand;
+            parent[y] = x;
+            parentEdge[y] = csrEdge[s];
+
+            next[y] = next[x];
+            prev[next[x]] = y;
+            next[x] = y;
+            prev[y] = x;
+            depth[y] = depth[x] + 1;
+            inTree[y] = 1;
+
+            if (!inQueue[y]) {
+                queue.push_back(y);
+                inQueue[y] = 1;
+            }
+        }
+    }
+
+    for (int s : q.disabledSlots) q.disabled[s] = 0;
+    q.disabledSlots.clear();
+    return scanned;
+}
+
+Graph::KernelWork Graph::runKernel(int start,
+                                   std::vector<double>& dist,
+                                   std::vector<int>& parent,
+                                   std::vector<int>& parentEdge,
+                                   std::vector<DetectedCycle>& found)
+{
+    ensureCsr();
+    return runKernel(start, dist, parent, parentEdge, found, ks, true, -1);
+}
+
+Graph::KernelWork Graph::runKernel(int start,
+                                   std::vector<double>& dist,
+                                   std::vector<int>& parent,
+                                   std::vector<int>& parentEdge,
+                                   std::vector<DetectedCycle>& found,
+                                   KernelScratch& q,
+                                   bool dedup,
+                                   int comp)
+{
+    if (relaxKernel == RelaxKernel::Queue) {
+        KernelWork work;
+        work.edges = relaxQueueFromSource(start, dist, parent, parentEdge, found, q, dedup, comp);
+        return work;
+    }
+
+    // A run that stopped early left no edge to relax, hence no cycle.
+    const KernelWork work = relaxFromSource(start, dist, parent, parentEdge, q.lastPass, comp);
+    if (work.passes == work.passBound) collectCycles(dist, parent, parentEdge, found, dedup, comp);
+    return work;
+}
+
+Graph::KernelWork Graph::runBatch(const int32_t* sources,
+                                  int count,
+                                  int comp,
+                                  std::vector<double>& dist,
+                                  std::vector<int>& parent,
+                                  std::vector<int>& parentEdge,
+                                  KernelScratch& q)
+{
+    const int V = static_cast<int>(nodeNames.size());
+    const size_t cells = static_cast<size_t>(V) * RELAX_BATCH;
+    const double INF = std::numeric_limits<double>::infinity();
+
+    // Lane b starts at sources[b]; unused lanes never leave INF.
+    q.batchDist.assign(cells, INF);
+    q.batchParent.assign(cells, -1);
+    q.batchParentEdge.assign(cells, -1);
+    q.lastPass.assign(V, -2);
+    for (int b = 0; b < count; ++b) {
+        q.batchDist[static_cast<size_t>(sources[b]) * RELAX_BATCH + b] = 0.0;
+        q.lastPass[sources[b]] = -1;
+    }
+
+    RelaxSpan span = spanFor(comp);
+    span.dist = q.batchDist.data();
+    span.parent = q.batchParent.data();
+    span.parentEdge = q.batchParentEdge.data();
+    span.lastPass = q.lastPass.data();
+
+    KernelWork work;
+    work.passBound = comp >= 0 ? sccNodeStart[comp + 1] - sccNodeStart[comp] - 1 : V - 1;
+    for (int i = 0; i < work.passBound; ++i) {
+        bool lowered = false;
+        work.edges += relaxBatchPass(span, i, lowered);
+        ++work.passes;
+        if (!lowered) break;
+    }
+
+    // Each lane now holds exactly what relaxFromSource() leaves for its
+    // source. Only lanes where some edge still relaxes can yield a cycle
+    // (collectCycles() looks at nothing else); a pass that lowered nothing
+    // rules them all out, otherwise probe the nodes the last pass touched.
+    unsigned open = 0;
+    if (work.passes == work.passBound) {
+        const int last = work.passBound - 1;
+        for (int i = 0; i < span.nodeCount; ++i) {
+            const int u = span.nodes ? span.nodes[i] : i;
+            if (q.lastPass[u] < last) continue;
+            const double* du = span.dist + static_cast<size_t>(u) * RELAX_BATCH;
+            for (int k = span.outStart[i]; k < span.outStart[i + 1]; ++k) {
+                const double* dv = span.dist + static_cast<size_t>(span.dst[k]) * RELAX_BATCH;
+                for (int b = 0; b < count; ++b) {
+                    if (du[b] + span.weight[k] < dv[b] - RELAX_EPS) open |= 1u << b;
+                }
+            }
+        }
+    }
+
+    dist.resize(V);
+    parent.resize(V);
+    parentEdge.resize(V);
+    for (int b = 0; b < count; ++b) {
+        if (!(open & (1u << b))) continue;
+        for (int n = 0; n < V; ++n) {
+            const size_t cell = static_cast<size_t>(n) * RELAX_BATCH + b;
+            dist[n] = q.batchDist[cell];
+            parent[n] = q.batchParent[cell];
+            parentEdge[n] = q.batchParentEdge[cell];
+        }
+        collectCycles(dist, parent, parentEdge, sourceCycles[sources[b]], false, comp);
+    }
+    return work;
+}
+
+bool Graph::repairPotential(int e, std::vector<DetectedCycle>& found)
+{
+    auto& pot = incr.potential;
+    auto& key = incr.key;
+    auto& parentEdge = incr.parentEdge;
+    auto& settled = incr.settled;
+    auto& touched = incr.touched;
+    auto& heap = incr.heap;
+    const auto later = std::greater<std::pair<double, int32_t>>();
+
+    const int u = edges.src(e);
+    const int v = edges.dst(e);
+    const double rc = edges.weight(e) + pot[u] - pot[v];
+    if (!(rc < -RELAX_EPS)) return false;
+
+    key[v] = rc;
+    parentEdge[v] = e;
+    touched.push_back(v);
+    heap.emplace_back(rc, v);
+
+    bool closed = false;
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), later);
+        const auto [k, x] = heap.back();
+        heap.pop_back();
+        if (settled[x] || k != key[x]) continue;
+        settled[x] = 1;
+
+        if (x == u) { closed = true; break; }
+
+        for (int s = csrOffsets[x]; s < csrOffsets[x + 1]; ++s) {
+            const int y = csrDst[s];
+            if (settled[y] || incr.isPending[csrEdge[s]]) continue;
+
+            const double r = std::max(0.0, csrWeight[s] + pot[x] - pot[y]);
+            const double cand = k + r;
+            if (cand < -RELAX_EPS && cand < key[y]) {
+                if (parentEdge[y] == -1) touched.push_back(y);
+                key[y] = cand;
+                parentEdge[y] = csrEdge[s];
+                heap.emplace_back(cand, y);
+                std::push_heap(heap.begin(), heap.end(), later);
+            }
+        }
+    }
+
+    if (closed) {
+        // Walk the repair tree back from u to v, then close with e.
+        std::vector<int> cycle;
+        std::vector<int> cycleEdgeIdx;
+        for (int x = u; ; x = edges.src(parentEdge[x])) {
+            cycle.push_back(x);
+            if (x == v) break;
+            cycleEdgeIdx.push_back(parentEdge[x]);
+        }
+        std::reverse(cycle.begin(), cycle.end());
+        std::reverse(cycleEdgeIdx.begin(), cycleEdgeIdx.end());
+        cycleEdgeIdx.push_back(e);
+
+        double profit = 0.0;
+        if (acceptCycle(cycle, cycleEdgeIdx, profit))
+            found.push_back(DetectedCycle{std::move(cycle), profit});
+    } else {
+        for (int x : touched) pot[x] += key[x];
+    }
+
+    for (int x : touched) {
+        key[x] = 0.0;
+        parentEdge[x] = -1;
+        settled[x] = 0;
+    }
+    touched.clear();
+    heap.clear();
+    return closed;
+}
+
+void Graph::findArbitrage() {
+    const int V = static_cast<int>(nodeNames.size());
+    if (V == 0) return;
+
+    using clock_wall = std::chrono::system_clock;
+
+    static bool warmupInitialized = false;
+    static std::time_t startEpoch = 0;
+    static std::time_t lastWarnedSec = -1;
+    const int WARMUP_SECONDS = 3;
+
+    std::time_t nowEpoch = std::chrono::system_clock::to_time_t(clock_wall::now());
+    if (!warmupInitialized) {
+        warmupInitialized = true;
+        startEpoch = nowEpoch;
+    }
+    if (!warmStarted && nowEpoch - startEpoch < WARMUP_SECONDS) {
+        if (nowEpoch != lastWarnedSec) {
+            std::tm tm = *std::localtime(&nowEpoch);
+            std::cout << "[warm-up] Ignoring arbitrage for another "
+                      << (WARMUP_SECONDS - (nowEpoch - startEpoch))
+                      << "s @ " << std::put_time(&tm, "%H:%M:%S") << std::endl;
+            lastWarnedSec = nowEpoch;
+        }
+        return;
+    }
+
+    static std::time_t lastSecond = 0;
+    static int foundThisSecond = 0;
+    if (rollSecondSummary("", lastSecond, foundThisSecond)) {
+        printSccStats("");
+        printCertificateStats("");
+        printScreenStats("");
+    }
+    if (certificateSkip()) return;
+
+    ensureCsr();
+    ensureScc();
+    screenComponents();
+
+    // Batched Bellman-Ford and the worker pool both screen every source
+    // first; the serial queue kernel reports as it goes.
+    if (detectionThreads > 1 || relaxKernel == RelaxKernel::BellmanFord) {
+        collectSources();
+
+        // Dedup in source order, exactly as the serial loop does.
+        for (int start : cyclicNodes) {
+            for (const auto& fc : sourceCycles[start]) {
+                if (isDuplicateCycle(canonicalSignature(fc.nodes, fc.profit))) continue;
+                announceCycle("", fc);
+                logArbitrageToCSV(fc.nodes, fc.profit);
+                foundThisSecond++;
+            }
+        }
+
+        rebuildCertificate();
+        return;
+    }
+
+    std::vector<double> dist;
+    std::vector<int> parent;
+    std::vector<int> parentEdge;
+    std::vector<DetectedCycle> found;
+
+    for (int start = 0; start < V; ++start) {
+        if (sccOf[start] < 0) continue;            // on no cycle of MIN_CYCLE_LEN+
+        if (screen.cleared[sccOf[start]]) continue;
+
+        found.clear();
+        runKernel(start, dist, parent, parentEdge, found, ks, true, sccOf[start]);
+
+        for (const auto& fc : found) {
+            announceCycle("", fc);
+            logArbitrageToCSV(fc.nodes, fc.profit);
+            foundThisSecond++;
+        }
+    }
+
+    rebuildCertificate();
+}
+
+void Graph::findArbitrageIncremental() {
+    const int V = static_cast<int>(nodeNames.size());
+    if (V == 0 || warmupActive()) return;
+
+    ensureCsr();
+
+    // New nodes start at potential 0; new edges are queued like changed ones.
+    const size_t E = edges.size();
+    if (incr.potential.size() < static_cast<size_t>(V)) {
+        incr.potential.resize(V, 0.0);
+        incr.key.resize(V, 0.0);
+        incr.parentEdge.resize(V, -1);
+        incr.settled.resize(V, 0);
+    }
+    if (incr.knownEdges < E) {
+        edgeChanged.resize(E, 0);
+        incr.isPending.resize(E, 0);
+        for (size_t e = incr.knownEdges; e < E; ++e) {
+            if (!edgeChanged[e]) {
+                edgeChanged[e] = 1;
+                changedEdges.push_back(static_cast<int32_t>(e));
+            }
+        }
+        incr.knownEdges = E;
+    }
+
+    static std::time_t lastSecond = 0;
+    static int foundThisSecond = 0;
+    rollSecondSummary("[Incremental] ", lastSecond, foundThisSecond);
+
+    std::vector<DetectedCycle> found;
+
+    // Edges already pending get their retry below.
+    const size_t retry = incr.pending.size();
+    for (int e : changedEdges) {
+        edgeChanged[e] = 0;
+        if (incr.isPending[e]) continue;
+        if (repairPotential(e, found)) {
+            incr.isPending[e] = 1;
+            incr.pending.push_back(e);
+        }
+    }
+    changedEdges.clear();
+
+    // A pending edge is released once no negative cycle runs through it.
+    size_t kept = 0;
+    for (size_t i = 0; i < incr.pending.size(); ++i) {
+        const int e = incr.pending[i];
+        if (i < retry) {
+            incr.isPending[e] = 0;
+            if (!repairPotential(e, found)) continue;
+            incr.isPending[e] = 1;
+        }
+        incr.pending[kept++] = e;
+    }
+    incr.pending.resize(kept);
+
+    for (const auto& fc : found) {
+        announceCycle("[Incremental] ", fc);
+        logArbitrageToCSV(fc.nodes, fc.profit);
+        foundThisSecond++;
+    }
+}
+
+void Graph::evaluatePolicy()
+{
+    const int V = static_cast<int>(nodeNames.size());
+    auto& h = howard;
+
+    h.mark.assign(V, 0);
+    for (int start = 0; start < V; ++start) {
+        if (!h.alive[start] || h.mark[start]) continue;
+
+        // Follow the policy until it reaches an evaluated node or loops.
+        h.path.clear();
+        int x = start;
+        while (h.mark[x] == 0) {
+            h.mark[x] = 1;
+            h.path.push_back(x);
+            x = edges.dst(h.policy[x]);
+        }
+
+        if (h.mark[x] == 1) {
+            // New cycle: x and everything after it on the walk.
+            size_t first = h.path.size() - 1;
+            while (h.path[first] != x) --first;
+
+            double sum = 0.0;
+            for (size_t i = first; i < h.path.size(); ++i) sum += edges.weight(h.policy[h.path[i]]);
+            const double mean = sum / static_cast<double>(h.path.size() - first);
+
+            h.eta[x] = mean;
+            h.d[x] = 0.0;
+            h.mark[x] = 2;
+            for (size_t i = h.path.size() - 1; i > first; --i) {
+                const int v = h.path[i];
+                const int e = h.policy[v];
+                h.eta[v] = mean;
+                h.d[v] = edges.weight(e) - mean + h.d[edges.dst(e)];
+                h.mark[v] = 2;
+            }
+            h.path.resize(first);
+        }
+
+        for (size_t i = h.path.size(); i-- > 0; ) {
+            const int v = h.path[i];
+            const int e = h.policy[v];
+            const int t = edges.dst(e);
+            h.eta[v] = h.eta[t];
+            h.d[v] = edges.weight(e) - h.eta[v] + h.d[t];
+            h.mark[v] = 2;
+        }
+    }
+}
+
+bool Graph::improvePolicy()
+{
+    const int V = static_cast<int>(nodeNames.size());
+    auto& h = howard;
+    bool changed = false;
+
+    for (int x = 0; x < V; ++x) {
+        if (!h.alive[x]) continue;
+        double best = h.eta[x];
+        int bestEdge = -1;
+        for (int s = csrOffsets[x]; s < csrOffsets[x + 1]; ++s) {
+            const int y = csrDst[s];
+            if (h.alive[y] && h.eta[y] < best - RELAX_EPS) {
+                best = h.eta[y];
+                bestEdge = csrEdge[s];
+            }
+        }
+        if (bestEdge >= 0) {
+            h.policy[x] = bestEdge;
+            changed = true;
+        }
+    }
+    if (changed) return true;
+
+    for (int x = 0; x < V; ++x) {
+        if (!h.alive[x]) continue;
+        double best = h.d[x];
+        int bestEdge = -1;
+        for (int s = csrOffsets[x]; s < csrOffsets[x + 1]; ++s) {
+            const int y = csrDst[s];
+            if (!h.alive[y] || std::fabs(h.eta[y] - h.eta[x]) > RELAX_EPS) continue;
+            const double val = csrWeight[s] - h.eta[x] + h.d[y];
+            if (val < best - RELAX_EPS) {
+                best = val;
+                bestEdge = csrEdge[s];
+            }
+        }
+        if (bestEdge >= 0) {
+            h.policy[x] = bestEdge;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+int Graph::runHoward()
+{
+    ensureCsr();
+
+    const int V = static_cast<int>(nodeNames.size());
+    const int E = static_cast<int>(edges.size());
+    auto& h = howard;
+
+    // Only nodes with an out-edge into another live node can reach a cycle.
+    h.alive.assign(V, 1);
+    for (bool pruned = true; pruned; ) {
+        pruned = false;
+        for (int x = 0; x < V; ++x) {
+            if (!h.alive[x]) continue;
+            bool out = false;
+            for (int s = csrOffsets[x]; s < csrOffsets[x + 1] && !out; ++s) out = h.alive[csrDst[s]];
+            if (!out) {
+                h.alive[x] = 0;
+                pruned = true;
+            }
+        }
+    }
+
+    // Keep last tick's choices where still valid; otherwise take the cheapest edge.
+    h.policy.resize(V, -1);
+    for (int x = 0; x < V; ++x) {
+        if (!h.alive[x]) {
+            h.policy[x] = -1;
+            continue;
+        }
+        const int e = h.policy[x];
+        if (e >= 0 && e < E && edges.src(e) == x && h.alive[edges.dst(e)]) continue;
+
+        int best = -1;
+        for (int s = csrOffsets[x]; s < csrOffsets[x + 1]; ++s) {
+            if (h.alive[csrDst[s]] && (best < 0 || csrWeight[s] < edges.weight(best)))
+                best = csrEdge[s];
+        }
+        h.policy[x] = best;
+    }
+
+    h.eta.resize(V);
+    h.d.resize(V);
+    h.cycle.clear();
+    h.cycleEdges.clear();
+    h.bestMean = 0.0;
+
+    int iterations = 0;
+    do {
+        evaluatePolicy();
+        ++iterations;
+    } while (improvePolicy() && iterations < HOWARD_MAX_ITERATIONS);
+
+    int bestNode = -1;
+    for (int x = 0; x < V; ++x) {
+        if (h.alive[x] && (bestNode < 0 || h.eta[x] < h.eta[bestNode])) bestNode = x;
+    }
+    if (bestNode < 0) return iterations;
+
+    // bestNode may sit on a tree leading into its cycle; walk until a repeat.
+    h.mark.assign(V, 0);
+    int x = bestNode;
+    while (!h.mark[x]) {
+        h.mark[x] = 1;
+        x = edges.dst(h.policy[x]);
+    }
+    const int entry = x;
+    do {
+        h.cycle.push_back(x);
+        h.cycleEdges.push_back(h.policy[x]);
+        x = edges.dst(h.policy[x]);
+    } while (x != entry);
+    h.bestMean = h.eta[bestNode];
+    return iterations;
+}
+
+void Graph::findMinMeanCycle() {
+    const int V = static_cast<int>(nodeNames.size());
+    if (V == 0 || warmupActive()) return;
+
+    static std::time_t lastSecond = 0;
+    static int foundThisSecond = 0;
+    rollSecondSummary("[MinMean] ", lastSecond, foundThisSecond);
+
+    runHoward();
+    if (!(howard.bestMean < -RELAX_EPS)) return;
+
+    double profit = 0.0;
+    if (!acceptCycle(howard.cycle, howard.cycleEdges, profit)) return;
+
+    DetectedCycle fc{howard.cycle, profit};
+    announceCycle("[MinMean] ", fc);
+    logArbitrageToCSV(fc.nodes, fc.profit);
+    foundThisSecond++;
+}
+
+void Graph::extendShortCycles(int start, int x)
+{
+    auto& sc = shortCycles;
+    for (int s = csrOffsets[x]; s < csrOffsets[x + 1]; ++s) {
+        const int y = csrDst[s];
+        const int len = static_cast<int>(sc.path.size()) + 1;
+
+        if (y == start) {
+            if (len < MIN_CYCLE_LEN) continue;
+            double sum = csrWeight[s];
+            for (int e : sc.path) {
+                sc.cycleEdges.push_back(e);
+                sum += edges.weight(e);
+            }
+            sc.cycleEdges.push_back(csrEdge[s]);
+            sc.cycleStart.push_back(static_cast<int32_t>(sc.cycleEdges.size()));
+            sc.sum.push_back(sum);
+            continue;
+        }
+        if (y < start || sc.onPath[y] || len >= sc.maxLen) continue;
+
+        sc.onPath[y] = 1;
+        sc.path.push_back(csrEdge[s]);
+        extendShortCycles(start, y);
+        sc.path.pop_back();
+        sc.onPath[y] = 0;
+    }
+}
+
+void Graph::rebuildShortCycles()
+{
+    ensureCsr();
+
+    const int V = static_cast<int>(nodeNames.size());
+    const int E = static_cast<int>(edges.size());
+    auto& sc = shortCycles;
+
+    sc.cycleStart.assign(1, 0);
+    sc.cycleEdges.clear();
+    sc.sum.clear();
+    sc.path.clear();
+    sc.onPath.assign(V, 0);
+    for (int s = 0; s < V; ++s) {
+        sc.onPath[s] = 1;
+        extendShortCycles(s, s);
+        sc.onPath[s] = 0;
+    }
+
+    const int C = static_cast<int>(sc.sum.size());
+    sc.edgeStart.assign(E + 1, 0);
+    for (int e : sc.cycleEdges) sc.edgeStart[e + 1]++;
+    for (int e = 0; e < E; ++e) sc.edgeStart[e + 1] += sc.edgeStart[e];
+    sc.edgeCycles.resize(sc.cycleEdges.size());
+    std::vector<int32_t> next(sc.edgeStart.begin(), sc.edgeStart.end() - 1);
+    for (int c = 0; c < C; ++c) {
+        for (int i = sc.cycleStart[c]; i < sc.cycleStart[c + 1]; ++i)
+            sc.edgeCycles[next[sc.cycleEdges[i]]++] = c;
+    }
+    sc.dirty.assign(C, 0);
+    sc.dirtyCycles.clear();
+    sc.topology = topologyVersion;
+    sc.nodes = V;
+}
+
+void Graph::printShortCycleStats(const char* prefix) const
+{
+    const auto& sc = shortCycles;
+    if (sc.topology == UINT64_MAX) return;
+
+    std::cout << prefix << "Indexed " << sc.sum.size() << " cycles of " << MIN_CYCLE_LEN
+              << ".." << sc.maxLen << " edges over " << sc.nodes << " nodes, "
+              << sc.edgeStart.size() - 1 << " edges\n";
+}
+
+void Graph::checkShortCycle(int c, std::vector<DetectedCycle>& found)
+{
+    static const double threshold = -std::log(PROFIT_MIN);
+    auto& sc = shortCycles;
+
+    double sum = 0.0;
+    for (int i = sc.cycleStart[c]; i < sc.cycleStart[c + 1]; ++i) sum += edges.weight(sc.cycleEdges[i]);
+    sc.sum[c] = sum;
+    if (!(sum < threshold)) return;
+
+    std::vector<int> cycleEdgeIdx(sc.cycleEdges.begin() + sc.cycleStart[c],
+                                  sc.cycleEdges.begin() + sc.cycleStart[c + 1]);
+    std::vector<int> cycle;
+    cycle.reserve(cycleEdgeIdx.size());
+    for (int e : cycleEdgeIdx) cycle.push_back(edges.src(e));
+
+    double profit = 0.0;
+    if (acceptCycle(cycle, cycleEdgeIdx, profit))
+        found.push_back(DetectedCycle{std::move(cycle), profit});
+}
+
+void Graph::findArbitrageShortCycles() {
+    const int V = static_cast<int>(nodeNames.size());
+    if (V == 0 || warmupActive()) return;
+
+    static std::time_t lastSecond = 0;
+    static int foundThisSecond = 0;
+    if (rollSecondSummary("[ShortCycles] ", lastSecond, foundThisSecond))
+        printShortCycleStats("[ShortCycles] ");
+
+    auto& sc = shortCycles;
+    std::vector<DetectedCycle> found;
+
+    if (sc.topology != topologyVersion) {
+        // New topology: every cycle is new, so check them all.
+        rebuildShortCycles();
+        edgeChanged.assign(edges.size(), 0);
+        changedEdges.clear();
+        for (int c = 0; c < static_cast<int>(sc.sum.size()); ++c) checkShortCycle(c, found);
+    } else {
+        for (int e : changedEdges) {
+            edgeChanged[e] = 0;
+            for (int i = sc.edgeStart[e]; i < sc.edgeStart[e + 1]; ++i) {
+                const int c = sc.edgeCycles[i];
+                if (sc.dirty[c]) continue;
+                sc.dirty[c] = 1;
+                sc.dirtyCycles.push_back(c);
+            }
+        }
+        changedEdges.clear();
+
+        for (int c : sc.dirtyCycles) {
+            sc.dirty[c] = 0;
+            checkShortCycle(c, found);
+        }
+        sc.dirtyCycles.clear();
+    }
+
+    for (const auto& fc : found) {
+        announceCycle("[ShortCycles] ", fc);
+        logArbitrageToCSV(fc.nodes, fc.profit);
+        foundThisSecond++;
+    }
+}
+
+int Graph::hopLimit() const
+{
+    return std::max(MIN_CYCLE_LEN, fixedPoint ? std::min(maxHops, TICK_MAX_HOPS) : maxHops);
+}
+
+int Graph::hopBoundedLayers(int s)
+{
+    const int V = static_cast<int>(nodeNames.size());
+    const int L = hopLimit();
+    const double INF = std::numeric_limits<double>::infinity();
+    auto& h = hop;
+
+    h.dist[s] = 0.0;
+    h.touched.push_back(s);
+    h.frontier.assign(1, s);
+
+    int bestLayer = -1;
+    double best = -RELAX_EPS;
+    for (int k = 1; k <= L && !h.frontier.empty(); ++k) {
+        const int base = k * V;
+        const int prevBase = base - V;
+        h.nextFrontier.clear();
+        for (int x : h.frontier) {
+            const double dx = h.dist[prevBase + x];
+            for (int slot = csrOffsets[x]; slot < csrOffsets[x + 1]; ++slot) {
+                const int y = csrDst[slot];
+                if (y < s) continue;
+                const double cand = dx + csrWeight[slot];
+                if (cand < h.dist[base + y]) {
+                    if (h.dist[base + y] == INF) {
+                        h.nextFrontier.push_back(y);
+                        h.touched.push_back(base + y);
+                    }
+                    h.dist[base + y] = cand;
+                    h.pred[base + y] = csrEdge[slot];
+                }
+            }
+        }
+        if (h.dist[base + s] < best) {
+            best = h.dist[base + s];
+            bestLayer = k;
+        }
+        std::swap(h.frontier, h.nextFrontier);
+    }
+
+    for (int idx : h.touched) h.dist[idx] = INF;
+    h.touched.clear();
+    return bestLayer;
+}
+
+int Graph::hopBoundedTickLayers(int s)
+{
+    const int V = static_cast<int>(nodeNames.size());
+    const int L = hopLimit();
+    auto& h = hop;
+
+    h.ticks[s] = 0;
+    h.touched.push_back(s);
+    h.frontier.assign(1, s);
+
+    TickLayerSpan span;
+    span.outStart = csrOffsets.data();
+    span.dst = csrDst.data();
+    span.ticks = csrTicks.data();
+    span.ids = csrEdge.data();
+    span.floor = s;
+    span.reached = &h.nextFrontier;
+
+    int bestLayer = -1;
+    int32_t best = 0;
+    for (int k = 1; k <= L && !h.frontier.empty(); ++k) {
+        const int base = k * V;
+        h.nextFrontier.clear();
+        span.frontier = h.frontier.data();
+        span.frontierCount = static_cast<int>(h.frontier.size());
+        span.prev = h.ticks.data() + base - V;
+        span.next = h.ticks.data() + base;
+        span.pred = h.pred.data() + base;
+        relaxTickLayer(span);
+        for (int y : h.nextFrontier) h.touched.push_back(base + y);
+
+        if (h.ticks[base + s] < best) {
+            best = h.ticks[base + s];
+            bestLayer = k;
+        }
+        std::swap(h.frontier, h.nextFrontier);
+    }
+
+    for (int idx : h.touched) h.ticks[idx] = TICK_INF;
+    h.touched.clear();
+    return bestLayer;
+}
+
+void Graph::bestHopBoundedCycle(int s, std::vector<DetectedCycle>& found)
+{
+    const int V = static_cast<int>(nodeNames.size());
+    auto& h = hop;
+
+    // Only the predecessors are read from here on.
+    const int bestLayer = fixedPoint ? hopBoundedTickLayers(s) : hopBoundedLayers(s);
+    // Integer tick sums pass the -RELAX_EPS test below from -1 on.
+    auto cost = [&](int e) -> double { return fixedPoint ? edges.ticks(e) : edges.weight(e); };
+
+    if (bestLayer > 0) {
+        // Rebuild the closed walk s -> ... -> s from the per-layer predecessors.
+        h.walk.clear();
+        for (int k = bestLayer, v = s; k > 0; --k) {
+            const int e = h.pred[k * V + v];
+            h.walk.push_back(e);
+            v = edges.src(e);
+        }
+        std::reverse(h.walk.begin(), h.walk.end());
+
+        // A negative closed walk splits into simple cycles, at least one of
+        // them negative; keep the cheapest.
+        std::vector<int> bestEdges;
+        double bestSum = -RELAX_EPS;
+        h.stackNodes.assign(1, s);
+        h.stackEdges.clear();
+        h.pos[s] = 0;
+        for (int e : h.walk) {
+            const int y = edges.dst(e);
+            const int p = h.pos[y];
+            if (p < 0) {
+                h.pos[y] = static_cast<int32_t>(h.stackNodes.size());
+                h.stackNodes.push_back(y);
+                h.stackEdges.push_back(e);
+                continue;
+            }
+            double sum = cost(e);
+            for (size_t i = p; i < h.stackEdges.size(); ++i) sum += cost(h.stackEdges[i]);
+            if (sum < bestSum) {
+                bestSum = sum;
+                bestEdges.assign(h.stackEdges.begin() + p, h.stackEdges.end());
+                bestEdges.push_back(e);
+            }
+            for (size_t i = p + 1; i < h.stackNodes.size(); ++i) h.pos[h.stackNodes[i]] = -1;
+            h.stackNodes.resize(p + 1);
+            h.stackEdges.resize(p);
+        }
+        for (int v : h.stackNodes) h.pos[v] = -1;
+
+        if (!bestEdges.empty()) {
+            std::vector<int> cycle;
+            cycle.reserve(bestEdges.size());
+            for (int e : bestEdges) cycle.push_back(edges.src(e));
+
+            double profit = 0.0;
+            if (acceptCycle(cycle, bestEdges, profit))
+                found.push_back(DetectedCycle{std::move(cycle), profit});
+        }
+    }
+}
+
+void Graph::findArbitrageHopBounded() {
+    const int V = static_cast<int>(nodeNames.size());
+    if (V == 0 || warmupActive()) return;
+
+    ensureCsr();
+
+    const size_t layers = static_cast<size_t>(hopLimit() + 1) * V;
+    if (hop.pred.size() != layers) hop.pred.assign(layers, -1);
+    if (fixedPoint && hop.ticks.size() != layers) hop.ticks.assign(layers, TICK_INF);
+    if (!fixedPoint && hop.dist.size() != layers) hop.dist.assign(layers, std::numeric_limits<double>::infinity());
+    hop.pos.assign(V, -1);
+
+    static std::time_t lastSecond = 0;
+    static int foundThisSecond = 0;
+    rollSecondSummary("[HopBounded] ", lastSecond, foundThisSecond);
+
+    std::vector<DetectedCycle> found;
+    for (int s = 0; s < V; ++s) {
+        found.clear();
+        bestHopBoundedCycle(s, found);
+
+        for (const auto& fc : found) {
+            announceCycle("[HopBounded] ", fc);
+            logArbitrageToCSV(fc.nodes, fc.profit);
+            foundThisSecond++;
+        }
+    }
+}
+
+// One Floyd-Warshall step for every pivot of tile kb, applied to tile
+// (ib, jb). Tiles are APSP_TILE x APSP_TILE so three of them stay in L1.
+static void relaxApspTile(double* dist, int32_t* next, int stride, int ib, int jb, int kb)
+{
+    const int i0 = ib * APSP_TILE;
+    const int j0 = jb * APSP_TILE;
+    const int k0 = kb * APSP_TILE;
+    for (int k = k0; k < k0 + APSP_TILE; ++k) {
+        const double* dk = dist + static_cast<size_t>(k) * stride + j0;
+        for (int i = i0; i < i0 + APSP_TILE; ++i) {
+            const size_t ik = static_cast<size_t>(i) * stride + k;
+            const double dik = dist[ik];
+            if (dik == std::numeric_limits<double>::infinity()) continue;
+            const int32_t first = next[ik];
+            double* di = dist + static_cast<size_t>(i) * stride + j0;
+            int32_t* ni = next + static_cast<size_t>(i) * stride + j0;
+            for (int j = 0; j < APSP_TILE; ++j) {
+                const double cand = dik + dk[j];
+                if (cand < di[j]) {
+                    di[j] = cand;
+                    ni[j] = first;
+                }
+            }
+        }
+    }
+}
+
+void Graph::rebuildAllPairs(std::vector<DetectedCycle>& found)
+{
+    ensureCsr();
+
+    const int V = static_cast<int>(nodeNames.size());
+    const int E = static_cast<int>(edges.size());
+    const double INF = std::numeric_limits<double>::infinity();
+    auto& ap = apsp;
+    ap.n = V;
+    ap.stride = (V + APSP_TILE - 1) / APSP_TILE * APSP_TILE;
+    const int N = ap.stride;
+    const size_t cells = static_cast<size_t>(N) * N;
+
+    // Known edges keep the weight the matrix last saw (held ones stay out
+    // or at their old weight); new ones come in at their current weight.
+    for (int e = static_cast<int>(ap.weight.size()); e < E; ++e) ap.weight.push_back(edges.weight(e));
+    ap.held.resize(E, 0);
+    edgeChanged.resize(E, 0);
+
+    ap.dist.assign(cells, INF);
+    ap.next.assign(cells, -1);
+    for (int i = 0; i < V; ++i) ap.dist[static_cast<size_t>(i) * N + i] = 0.0;
+    for (int u = 0; u < V; ++u) {
+        for (int slot = csrOffsets[u]; slot < csrOffsets[u + 1]; ++slot) {
+            const size_t uv = static_cast<size_t>(u) * N + csrDst[slot];
+            const double w = ap.weight[csrEdge[slot]] + APSP_HOP_MARGIN;
+            if (w < ap.dist[uv]) {
+                ap.dist[uv] = w;
+                ap.next[uv] = csrEdge[slot];
+            }
+        }
+    }
+
+    // Blocked Floyd-Warshall: for each pivot tile, the diagonal tile first,
+    // then the rest of its row and column, then everything else, so every
+    // tile only reads tiles already final for this pivot.
+    const int T = N / APSP_TILE;
+    double* d = ap.dist.data();
+    int32_t* nx = ap.next.data();
+    for (int kb = 0; kb < T; ++kb) {
+        relaxApspTile(d, nx, N, kb, kb, kb);
+        for (int b = 0; b < T; ++b) {
+            if (b == kb) continue;
+            relaxApspTile(d, nx, N, kb, b, kb);
+            relaxApspTile(d, nx, N, b, kb, kb);
+        }
+        for (int ib = 0; ib < T; ++ib) {
+            if (ib == kb) continue;
+            for (int jb = 0; jb < T; ++jb)
+                if (jb != kb) relaxApspTile(d, nx, N, ib, jb, kb);
+        }
+    }
+
+    ap.topology = topologyVersion;
+    ap.loosened = 0;
+    ++ap.rebuilds;
+
+    bool cyclic = false;
+    for (int i = 0; i < V && !cyclic; ++i) cyclic = ap.dist[static_cast<size_t>(i) * N + i] < -RELAX_EPS;
+    if (!cyclic) return;
+
+    // New markets closed a negative cycle, which leaves the distances
+    // meaningless. Start from no edges and settle them one at a time, so
+    // each edge that closes a cycle is held out and reported.
+    std::fill(ap.dist.begin(), ap.dist.end(), INF);
+    std::fill(ap.next.begin(), ap.next.end(), -1);
+    for (int i = 0; i < V; ++i) ap.dist[static_cast<size_t>(i) * N + i] = 0.0;
+    ap.weight.assign(E, INF);
+    ap.held.assign(E, 0);
+    ap.heldEdges.clear();
+    for (int e = 0; e < E; ++e) settleAllPairsEdge(e, found);
+}
+
+void Graph::foldAllPairsEdge(int e)
+{
+    auto& ap = apsp;
+    const int V = ap.n;
+    const int N = ap.stride;
+    const int u = edges.src(e);
+    const int v = edges.dst(e);
+    const double w = ap.weight[e] + APSP_HOP_MARGIN;
+    if (!(w < ap.dist[static_cast<size_t>(u) * N + v])) return;
+
+    // Every new path is i -> u, then e, then v -> j, using column u and row
+    // v as they were before this fold.
+    ap.colDist.resize(V);
+    ap.colNext.resize(V);
+    for (int i = 0; i < V; ++i) {
+        ap.colDist[i] = ap.dist[static_cast<size_t>(i) * N + u];
+        ap.colNext[i] = ap.next[static_cast<size_t>(i) * N + u];
+    }
+    ap.rowDist.assign(ap.dist.begin() + static_cast<size_t>(v) * N,
+                      ap.dist.begin() + static_cast<size_t>(v) * N + V);
+
+    for (int i = 0; i < V; ++i) {
+        if (ap.colDist[i] == std::numeric_limits<double>::infinity()) continue;
+        const double viaEdge = ap.colDist[i] + w;
+        const int32_t first = ap.colNext[i] < 0 ? e : ap.colNext[i];
+        double* di = ap.dist.data() + static_cast<size_t>(i) * N;
+        int32_t* ni = ap.next.data() + static_cast<size_t>(i) * N;
+        for (int j = 0; j < V; ++j) {
+            const double cand = viaEdge + ap.rowDist[j];
+            if (cand < di[j] && j != i) {
+                di[j] = cand;
+                ni[j] = first;
+            }
+        }
+    }
+}
+
+bool Graph::settleAllPairsEdge(int e, std::vector<DetectedCycle>& found)
+{
+    auto& ap = apsp;
+    const int N = ap.stride;
+    const int u = edges.src(e);
+    const int v = edges.dst(e);
+    const double w = edges.weight(e);
+    const double back = ap.dist[static_cast<size_t>(v) * N + u];
+
+    if (w + APSP_HOP_MARGIN + back < -RELAX_EPS) {
+        // e closes a negative cycle with the stored path v -> u, which is
+        // simple because the matrix itself holds no negative cycle.
+        std::vector<int> cycleEdgeIdx(1, e);
+        double sum = w + APSP_HOP_MARGIN;
+        for (int x = v; x != u && static_cast<int>(cycleEdgeIdx.size()) <= ap.n; ) {
+            const int f = ap.next[static_cast<size_t>(x) * N + u];
+            cycleEdgeIdx.push_back(f);
+            sum += edges.weight(f) + APSP_HOP_MARGIN;
+            x = edges.dst(f);
+        }
+        if (static_cast<int>(cycleEdgeIdx.size()) <= ap.n && sum < -RELAX_EPS) {
+            if (!ap.held[e]) {
+                ap.held[e] = 1;
+                ap.heldEdges.push_back(e);
+            }
+            std::vector<int> cycle;
+            cycle.reserve(cycleEdgeIdx.size());
+            for (int f : cycleEdgeIdx) cycle.push_back(edges.src(f));
+
+            double profit = 0.0;
+            if (acceptCycle(cycle, cycleEdgeIdx, profit))
+                found.push_back(DetectedCycle{std::move(cycle), profit});
+            return true;
+        }
+        // Only a loosened lower bound can make the stored path look cheaper
+        // than it is.
+        if (ap.loosened > 0) return false;
+    }
+
+    if (w > ap.weight[e]) {
+        // Stored paths leaving u through e keep its old weight, so entries
+        // become lower bounds until the next rebuild.
+        const int32_t* nu = ap.next.data() + static_cast<size_t>(u) * N;
+        if (std::find(nu, nu + ap.n, e) != nu + ap.n) {
+            ++ap.loosened;
+            ap.weight[e] = w;
+            return true;
+        }
+    }
+    ap.weight[e] = w;
+    foldAllPairsEdge(e);
+    return true;
+}
+
+void Graph::findArbitrageAllPairs() {
+    const int V = static_cast<int>(nodeNames.size());
+    if (V == 0 || warmupActive()) return;
+
+    auto& ap = apsp;
+    static std::time_t lastSecond = 0;
+    static int foundThisSecond = 0;
+    if (rollSecondSummary("[AllPairs] ", lastSecond, foundThisSecond))
+        std::cout << "[AllPairs] " << ap.folds << " edge updates folded, "
+                  << ap.rebuilds << " rebuilds, " << ap.heldEdges.size() << " edges held\n";
+
+    std::vector<DetectedCycle> found;
+    // V loosened edges pay for one O(V^3) rebuild, keeping the amortized
+    // cost at O(V^2) per edge.
+    if (ap.topology != topologyVersion || ap.n != V || ap.loosened > V) rebuildAllPairs(found);
+
+    auto settle = [&](int e, std::vector<DetectedCycle>& out) {
+        if (settleAllPairsEdge(e, out)) return;
+        rebuildAllPairs(out);
+        settleAllPairsEdge(e, out);
+    };
+
+    // Held edges are rechecked after the changed ones: each either still
+    // closes its cycle, which was reported when it was first held, or is
+    // folded back in.
+    std::vector<int> recheck;
+    recheck.swap(ap.heldEdges);
+    for (int e : recheck) ap.held[e] = 0;
+
+    for (int e : changedEdges) {
+        edgeChanged[e] = 0;
+        settle(e, found);
+    }
+    ap.folds += changedEdges.size();
+    changedEdges.clear();
+
+    std::vector<DetectedCycle> reported;
+    for (int e : recheck)
+        if (!ap.held[e]) settle(e, reported);
+
+    for (const auto& fc : found) {
+        announceCycle("[AllPairs] ", fc);
+        logArbitrageToCSV(fc.nodes, fc.profit);
+        foundThisSecond++;
+    }
+}
+
+void Graph::computeTropicalPowers()
+{
+    const int V = static_cast<int>(nodeNames.size());
+    const int E = static_cast<int>(edges.size());
+    const int L = std::max(MIN_CYCLE_LEN, shortCycles.maxLen);
+    auto& tp = tropical;
+    const int N = (V + MINPLUS_TILE - 1) / MINPLUS_TILE * MINPLUS_TILE;
+    const size_t cells = static_cast<size_t>(N) * N;
+
+    if (tp.topology != topologyVersion || tp.n != V || tp.maxLen != L) {
+        tp.n = V;
+        tp.stride = N;
+        tp.maxLen = L;
+        tp.edge.assign(cells, -1);
+        tp.power.assign(L * cells, std::numeric_limits<double>::infinity());
+        tp.arg.assign(L * cells, -1);
+        for (int e = 0; e < E; ++e) tp.edge[static_cast<size_t>(edges.src(e)) * N + edges.dst(e)] = e;
+        tp.topology = topologyVersion;
+    }
+
+    // Layer 1 is W itself, refreshed from the live weights.
+    for (int e = 0; e < E; ++e) tp.power[static_cast<size_t>(edges.src(e)) * N + edges.dst(e)] = edges.weight(e);
+
+    MinPlusSpan span;
+    span.b = tp.power.data();
+    span.n = V;
+    span.stride = N;
+    for (int k = 2; k <= L; ++k) {
+        span.a = tp.power.data() + (k - 2) * cells;
+        span.c = tp.power.data() + (k - 1) * cells;
+        span.arg = tp.arg.data() + (k - 1) * cells;
+        minPlusProduct(span);
+    }
+}
+
+bool Graph::tropicalCycle(int i, int k, std::vector<int>& cycle, std::vector<int>& cycleEdgeIdx) const
+{
+    // Read the closed k-walk through i back from its last edge.
+    const auto& tp = tropical;
+    const int N = tp.stride;
+    const size_t cells = static_cast<size_t>(N) * N;
+    std::vector<int> walk(k);
+    int v = i;
+    for (int layer = k; layer >= 2; --layer) {
+        const int m = tp.arg[(layer - 1) * cells + static_cast<size_t>(i) * N + v];
+        walk[layer - 1] = tp.edge[static_cast<size_t>(m) * N + v];
+        v = m;
+    }
+    walk[0] = tp.edge[static_cast<size_t>(i) * N + v];
+
+    // A walk that revisits a node splits into simple cycles, at least one
+    // of them negative; keep the cheapest.
+    std::vector<int> pos(tp.n, -1);
+    std::vector<int> stackNodes(1, i), stackEdges;
+    pos[i] = 0;
+    double bestSum = -RELAX_EPS;
+    for (int e : walk) {
+        const int y = edges.dst(e);
+        const int p = pos[y];
+        if (p < 0) {
+            pos[y] = static_cast<int>(stackNodes.size());
+            stackNodes.push_back(y);
+            stackEdges.push_back(e);
+            continue;
+        }
+        double sum = edges.weight(e);
+        for (size_t q = p; q < stackEdges.size(); ++q) sum += edges.weight(stackEdges[q]);
+        if (sum < bestSum) {
+            bestSum = sum;
+            cycleEdgeIdx.assign(stackEdges.begin() + p, stackEdges.end());
+            cycleEdgeIdx.push_back(e);
+        }
+        for (size_t q = p + 1; q < stackNodes.size(); ++q) pos[stackNodes[q]] = -1;
+        stackNodes.resize(p + 1);
+        stackEdges.resize(p);
     }
+    if (cycleEdgeIdx.empty()) return false;
 
-    static constexpr double RELAX_EPS = 1e-9;
-    static constexpr double PROFIT_MIN_LOCAL = 1.005;
-    static constexpr double PROFIT_MAX_LOCAL = 10.0;
+    cycle.clear();
+    for (int e : cycleEdgeIdx) cycle.push_back(edges.src(e));
+    return true;
+}
 
-    for (int start = 0; start < V; ++start) {
-        std::vector<double> dist(V, std::numeric_limits<double>::infinity());
-        std::vector<int> parent(V, -1);
-        std::vector<int> parentEdge(V, -1);
-        dist[start] = 0.0;
-
-        for (int i = 0; i < V - 1; ++i) {
-            for (int ei = 0; ei < (int)edges.size(); ++ei) {
-                const auto& e = edges[ei];
-                
-                if (dist[e.source] != std::numeric_limits<double>::infinity() &&
-                    dist[e.source] + e.weight < dist[e.destination]) {
-                    dist[e.destination] = dist[e.source] + e.weight;
-                    parent[e.destination] = e.source;
-                    parentEdge[e.destination] = ei;
-                }
-            }
+void Graph::collectTropicalCycles(std::vector<DetectedCycle>& found)
+{
+    static const double threshold = -std::log(PROFIT_MIN);
+    const auto& tp = tropical;
+    const size_t cells = static_cast<size_t>(tp.stride) * tp.stride;
+    for (int k = MIN_CYCLE_LEN; k <= tp.maxLen; ++k) {
+        const double* Wk = tp.power.data() + (k - 1) * cells;
+        for (int i = 0; i < tp.n; ++i) {
+            if (!(Wk[static_cast<size_t>(i) * tp.stride + i] < threshold)) continue;
+
+            std::vector<int> cycle, cycleEdgeIdx;
+            double profit = 0.0;
+            if (tropicalCycle(i, k, cycle, cycleEdgeIdx) && acceptCycle(cycle, cycleEdgeIdx, profit))
+                found.push_back(DetectedCycle{std::move(cycle), profit});
         }
+    }
+}
 
-        for (int ei = 0; ei < (int)edges.size(); ++ei) {
-            const auto& e = edges[ei];
-            
-            if (dist[e.source] != std::numeric_limits<double>::infinity() &&
-                dist[e.source] + e.weight < dist[e.destination] - RELAX_EPS) {
-                
-                parent[e.destination] = e.source;
-                parentEdge[e.destination] = ei;
-                
-                int v = e.destination;
-                for (int i = 0; i < V; ++i) {
-                    v = parent[v];
-                }
-
-                std::vector<int> cycle;
-                int cur = v;
-                do {
-                    cycle.push_back(cur);
-                    cur = parent[cur];
-                } while (cur != v && cur != -1);
-                
-                if (cycle.empty()) continue;
-                std::reverse(cycle.begin(), cycle.end());
+void Graph::findArbitrageTropical() {
+    const int V = static_cast<int>(nodeNames.size());
+    if (V == 0 || warmupActive()) return;
 
-                const int n = (int)cycle.size();
-                std::vector<int> cycleEdgeIdx;
-                cycleEdgeIdx.reserve(n);
-                bool edgesOk = true;
-                
-                for (int i = 0; i < n; ++i) {
-                    int toNode = cycle[(i + 1) % n];
-                    int pe = parentEdge[toNode];
-                    
-                    if (pe < 0 || 
-                        edges[pe].source != cycle[i] || 
-                        edges[pe].destination != toNode) {
-                        edgesOk = false;
-                        break;
-                    }
-                    cycleEdgeIdx.push_back(pe);
-                }
-                
-                if (!edgesOk) continue;
+    static std::time_t lastSecond = 0;
+    static int foundThisSecond = 0;
+    rollSecondSummary("[Tropical] ", lastSecond, foundThisSecond);
 
-                double profit = 1.0;
-                for (int pe : cycleEdgeIdx) {
-                    double p = edges[pe].price;
-                    if (!std::isfinite(p) || p <= 0.0) {
-                        profit = std::numeric_limits<double>::quiet_NaN();
-                        break;
-                    }
-                    profit *= p;
-                    if (!std::isfinite(profit)) break;
-                }
+    computeTropicalPowers();
 
-                if (!std::isfinite(profit)) continue;
-                if (profit <= 0.0 || profit > PROFIT_MAX_LOCAL) continue;
-                if ((int)cycle.size() < MIN_CYCLE_LEN) continue;
-                if (profit < PROFIT_MIN_LOCAL) continue;
+    std::vector<DetectedCycle> found;
+    collectTropicalCycles(found);
 
-                std::string sig = canonicalSignature(cycle, profit);
-                if (isDuplicateCycle(sig)) continue;
+    for (const auto& fc : found) {
+        announceCycle("[Tropical] ", fc);
+        logArbitrageToCSV(fc.nodes, fc.profit);
+        foundThisSecond++;
+    }
+}
 
-                std::ostringstream path;
-                for (int nidx : cycle) {
-                    path << nodeNames[nidx] << " -> ";
-                }
-                path << nodeNames[cycle.front()];
+void Graph::treePotential(std::vector<double>& potential, std::vector<int32_t>& queue) const
+{
+    const int V = static_cast<int>(nodeNames.size());
+    const double INF = std::numeric_limits<double>::infinity();
+
+    // Every market has its inverse, so a BFS over out-edges covers each
+    // connected piece. Tree edges get re-based weight 0; the rest are left
+    // with about the mispricing of the cycle they close.
+    potential.assign(V, INF);
+    queue.clear();
+    for (int root = 0; root < V; ++root) {
+        if (potential[root] != INF) continue;
+        potential[root] = 0.0;
+        queue.push_back(root);
+        for (size_t head = queue.size() - 1; head < queue.size(); ++head) {
+            const int x = queue[head];
+            for (int slot = csrOffsets[x]; slot < csrOffsets[x + 1]; ++slot) {
+                const int y = csrDst[slot];
+                if (potential[y] != INF) continue;
+                potential[y] = potential[x] + csrWeight[slot];
+                queue.push_back(y);
+            }
+        }
+    }
+}
 
-                std::time_t ts = clock_wall::to_time_t(clock_wall::now());
-                std::tm ts_tm = *std::localtime(&ts);
-                
-                std::ostringstream pss;
-                pss << std::fixed << std::setprecision(10) << profit;
+void Graph::prepareTopK()
+{
+    ensureCsr();
 
-                std::cout << "[" << std::put_time(&ts_tm, "%Y-%m-%d %H:%M:%S") << "] "
-                          << "[!] Arbitrage found! Profit = " << pss.str()
-                          << "x | Path: " << path.str() << "\n";
+    const int V = static_cast<int>(nodeNames.size());
+    const int L = std::max(MIN_CYCLE_LEN, maxHops);
+    const double INF = std::numeric_limits<double>::infinity();
+    auto& tk = topK;
+
+    treePotential(tk.potential, tk.queue);
+
+    const int E = static_cast<int>(csrDst.size());
+    tk.reduced.resize(E);
+    tk.order.resize(E);
+    for (int x = 0; x < V; ++x) {
+        for (int slot = csrOffsets[x]; slot < csrOffsets[x + 1]; ++slot) {
+            tk.reduced[slot] = csrWeight[slot] + tk.potential[x] - tk.potential[csrDst[slot]];
+            tk.order[slot] = slot;
+        }
+        // Cheapest first, so good cycles tighten the cutoff early.
+        std::sort(tk.order.begin() + csrOffsets[x], tk.order.begin() + csrOffsets[x + 1],
+                  [&](int32_t a, int32_t b) { return tk.reduced[a] < tk.reduced[b]; });
+    }
 
-                logArbitrageToCSV(cycle, profit);
+    tk.bound.assign(static_cast<size_t>(L + 1) * V, INF);
+    double* first = tk.bound.data() + V;
+    for (int x = 0; x < V; ++x) {
+        for (int slot = csrOffsets[x]; slot < csrOffsets[x + 1]; ++slot)
+            first[x] = std::min(first[x], tk.reduced[slot]);
+    }
+    for (int r = 2; r <= L; ++r) {
+        const double* prev = tk.bound.data() + static_cast<size_t>(r - 1) * V;
+        double* cur = tk.bound.data() + static_cast<size_t>(r) * V;
+        for (int x = 0; x < V; ++x) {
+            double b = first[x];
+            for (int slot = csrOffsets[x]; slot < csrOffsets[x + 1]; ++slot)
+                b = std::min(b, tk.reduced[slot] + prev[csrDst[slot]]);
+            cur[x] = b;
+        }
+    }
+}
 
-                foundThisSecond++;
+void Graph::extendTopK(TopKWorker& w, int start, int x, double sum)
+{
+    static const double threshold = -std::log(PROFIT_MIN_LOCAL);
+    static const double floor = -std::log(PROFIT_MAX_LOCAL);  // screenCycle drops these
+    const int V = static_cast<int>(nodeNames.size());
+    const int L = std::max(MIN_CYCLE_LEN, maxHops);
+    const auto& tk = topK;
+    const int len = static_cast<int>(w.path.size()) + 1;      // edges after this step
+    const double* rest = tk.bound.data() + static_cast<size_t>(L - len) * V;
+
+    for (int i = csrOffsets[x]; i < csrOffsets[x + 1]; ++i) {
+        const int slot = tk.order[i];
+        const int y = csrDst[slot];
+        const double next = sum + tk.reduced[slot];
+        const double cutoff = static_cast<int>(w.best.size()) < tk.k ? threshold : w.best.front().first;
+
+        if (y == start) {
+            if (len < MIN_CYCLE_LEN || !(next < cutoff) || next <= floor) continue;
+            if (static_cast<int>(w.best.size()) == tk.k) {
+                std::pop_heap(w.best.begin(), w.best.end());
+                w.best.back().first = next;
+                w.best.back().second.assign(w.path.begin(), w.path.end());
+            } else {
+                w.best.emplace_back(next, w.path);
             }
+            w.best.back().second.push_back(csrEdge[slot]);
+            std::push_heap(w.best.begin(), w.best.end());
+            continue;
+        }
+        if (y < start || w.onPath[y] || len >= L) continue;
+        if (!(next + rest[y] < cutoff)) {
+            w.cut++;
+            continue;
+        }
+
+        w.expanded++;
+        w.onPath[y] = 1;
+        w.path.push_back(csrEdge[slot]);
+        extendTopK(w, start, y, next);
+        w.path.pop_back();
+        w.onPath[y] = 0;
+    }
+}
+
+void Graph::collectTopKCycles(std::vector<std::pair<double, std::vector<int32_t>>>& best)
+{
+    const int V = static_cast<int>(nodeNames.size());
+    auto& tk = topK;
+
+    // Everything the workers read is built here, before they start.
+    prepareTopK();
+    ensurePool();
+    tk.workers.resize(detectionThreads);
+    for (auto& w : tk.workers) {
+        w.best.clear();
+        w.path.clear();
+        w.onPath.assign(V, 0);
+        w.expanded = 0;
+        w.cut = 0;
+    }
+
+    // Low-numbered starts search the most nodes, so hand them out one at a
+    // time off a shared counter.
+    std::atomic<int> nextStart{0};
+    auto work = [&](int worker) {
+        auto& w = tk.workers[worker];
+        for (int s; (s = nextStart.fetch_add(1, std::memory_order_relaxed)) < V; ) {
+            w.onPath[s] = 1;
+            extendTopK(w, s, s, 0.0);
+            w.onPath[s] = 0;
         }
+    };
+    if (pool && detectionThreads > 1) pool->run(work);
+    else work(0);
+
+    best.clear();
+    for (auto& w : tk.workers) {
+        for (auto& entry : w.best) best.push_back(std::move(entry));
+        tk.expanded += w.expanded;
+        tk.cut += w.cut;
+    }
+    std::sort(best.begin(), best.end());
+    if (static_cast<int>(best.size()) > tk.k) best.resize(tk.k);
+}
+
+void Graph::findArbitrageTopK() {
+    const int V = static_cast<int>(nodeNames.size());
+    if (V == 0 || warmupActive()) return;
+
+    static std::time_t lastSecond = 0;
+    static int foundThisSecond = 0;
+    if (rollSecondSummary("[TopK] ", lastSecond, foundThisSecond))
+        std::cout << "[TopK] " << topK.expanded << " steps taken, "
+                  << topK.cut << " cut by the bound\n";
+
+    std::vector<std::pair<double, std::vector<int32_t>>> best;
+    collectTopKCycles(best);
+
+    for (const auto& entry : best) {
+        std::vector<int> cycleEdgeIdx(entry.second.begin(), entry.second.end());
+        std::vector<int> cycle;
+        cycle.reserve(cycleEdgeIdx.size());
+        for (int e : cycleEdgeIdx) cycle.push_back(edges.src(e));
+
+        double profit = 0.0;
+        if (!acceptCycle(cycle, cycleEdgeIdx, profit)) continue;
+
+        DetectedCycle fc{std::move(cycle), profit};
+        announceCycle("[TopK] ", fc);
+        logArbitrageToCSV(fc.nodes, fc.profit);
+        foundThisSecond++;
     }
 }
 
@@ -350,11 +2640,14 @@ void Graph::printGraphSummary(int maxEdgesToShow) {
               << "\nTotal edges: " << edges.size() << std::endl;
 
     int countBinance = 0, countOKX = 0, countBybit = 0, countCross = 0;
-    for (const auto& e : edges) {
-        if (e.exchange == "Cross") countCross++;
-        else if (e.exchange == "Binance") countBinance++;
-        else if (e.exchange == "OKX") countOKX++;
-        else if (e.exchange == "Bybit") countBybit++;
+    for (size_t ei = 0; ei < edges.size(); ++ei) {
+        const int exchId = edges.exchange(static_cast<int>(ei));
+        if (exchId == NO_EXCHANGE) continue;
+        const std::string& exch = exchangeNames[exchId];
+        if (exch == "Cross") countCross++;
+        else if (exch == "Binance") countBinance++;
+        else if (exch == "OKX") countOKX++;
+        else if (exch == "Bybit") countBybit++;
     }
 
     std::cout << "  Binance edges: " << countBinance
@@ -364,21 +2657,17 @@ void Graph::printGraphSummary(int maxEdgesToShow) {
 
     std::cout << "\n--- List (max " << maxEdgesToShow << ") ---\n";
     int shown = 0;
-    for (const auto& e : edges) {
-        std::cout << nodeNames[e.source] << " -> " << nodeNames[e.destination]
-                  << " | weight=" << e.weight
-                  << " | price=" << std::exp(-e.weight) << std::endl;
+    for (size_t ei = 0; ei < edges.size(); ++ei) {
+        std::cout << nodeNames[edges.src(ei)] << " -> " << nodeNames[edges.dst(ei)]
+                  << " | weight=" << edges.weight(ei)
+                  << " | price=" << std::exp(-edges.weight(ei)) << std::endl;
         if (++shown >= maxEdgesToShow) break;
     }
     std::cout << "===============================\n";
 }
 
-void Graph::ensureSuperSourceEdges() {
-    if (superSourceId == -1) superSourceId = addNode("SUPER_SOURCE");
-    for (size_t i = lastSuperEdgeAddForNodeCount; i < nodeNames.size(); ++i)
-        if ((int)i != superSourceId)
-            addOrUpdateEdge("SUPER_SOURCE", nodeNames[i], 1.0, "Cross", "SUPER");
-    lastSuperEdgeAddForNodeCount = nodeNames.size();
+void Graph::ensureSuperSource() {
+    if (superSourceId == -1) superSourceId = addNode(internAsset("SUPER_SOURCE"), NO_EXCHANGE);
 }
 
 bool Graph::warmupActive() {
@@ -387,6 +2676,7 @@ bool Graph::warmupActive() {
     const int WARMUP_SECONDS = 3;
     std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
     if (!init) { init = true; start = now; }
+    if (warmStarted) return nodeNames.size() < 3;
     return (now - start < WARMUP_SECONDS) || nodeNames.size() < 3;
 }
 
@@ -394,237 +2684,80 @@ void Graph::findArbitrageSuperSource() {
     const int V = static_cast<int>(nodeNames.size());
     if (V == 0 || warmupActive()) return;
     
-    ensureSuperSourceEdges();
+    ensureSuperSource();
     if (superSourceId < 0 || superSourceId >= V) return;
 
-    using clock_wall = std::chrono::system_clock;
-
     static std::time_t lastSecond = 0;
     static int foundThisSecond = 0;
+    if (rollSecondSummary("[SuperSource] ", lastSecond, foundThisSecond))
+        printCertificateStats("[SuperSource] ");
+    if (certificateSkip()) return;
 
-    std::time_t secNow = clock_wall::to_time_t(clock_wall::now());
-    if (lastSecond == 0) lastSecond = secNow;
-    
-    if (secNow != lastSecond) {
-        if (foundThisSecond == 0) {
-            std::tm t = *std::localtime(&lastSecond);
-            std::cout << "[SuperSource] --- No arbitrage between "
-                      << std::put_time(&t, "%H:%M:%S") << " and "
-                      << std::put_time(std::localtime(&secNow), "%H:%M:%S")
-                      << " ---\n";
-        } else {
-            std::tm t = *std::localtime(&lastSecond);
-            std::cout << "[SuperSource] === Arbitrages found @ " << std::put_time(&t, "%H:%M:%S")
-                      << " => " << foundThisSecond << " ===\n\n";
-        }
-        foundThisSecond = 0;
-        lastSecond = secNow;
-    }
-
-    static constexpr double RELAX_EPS = 1e-9;
-    static constexpr double PROFIT_MIN_LOCAL = 1.005;
-    static constexpr double PROFIT_MAX_LOCAL = 10.0;
+    std::vector<double> dist;
+    std::vector<int> parent;
+    std::vector<int> parentEdge;
+    std::vector<DetectedCycle> found;
 
-    std::vector<double> dist(V, std::numeric_limits<double>::infinity());
-    std::vector<int> parent(V, -1);
-    std::vector<int> parentEdge(V, -1);
-    dist[superSourceId] = 0.0;
+    runKernel(superSourceId, dist, parent, parentEdge, found);
 
-    for (int i = 0; i < V - 1; ++i) {
-        for (int ei = 0; ei < (int)edges.size(); ++ei) {
-            const auto& e = edges[ei];
-            
-            if (dist[e.source] != std::numeric_limits<double>::infinity() &&
-                dist[e.source] + e.weight < dist[e.destination]) {
-                dist[e.destination] = dist[e.source] + e.weight;
-                parent[e.destination] = e.source;
-                parentEdge[e.destination] = ei;
-            }
-        }
+    for (const auto& fc : found) {
+        announceCycle("[SuperSource] ", fc);
+        foundThisSecond++;
     }
 
-    for (int ei = 0; ei < (int)edges.size(); ++ei) {
-        const auto& e = edges[ei];
-        
-        if (dist[e.source] != std::numeric_limits<double>::infinity() &&
-            dist[e.source] + e.weight < dist[e.destination] - RELAX_EPS) {
-            
-            parent[e.destination] = e.source;
-            parentEdge[e.destination] = ei;
-            
-            int v = e.destination;
-            for (int i = 0; i < V; ++i) {
-                v = parent[v];
-            }
-
-            std::vector<int> cycle;
-            int cur = v;
-            do {
-                cycle.push_back(cur);
-                cur = parent[cur];
-            } while (cur != v && cur != -1);
-            
-            if (cycle.empty()) continue;
-            std::reverse(cycle.begin(), cycle.end());
-
-            const int n = (int)cycle.size();
-            std::vector<int> cycleEdgeIdx;
-            cycleEdgeIdx.reserve(n);
-            bool edgesOk = true;
-            
-            for (int i = 0; i < n; ++i) {
-                int toNode = cycle[(i + 1) % n];
-                int pe = parentEdge[toNode];
-                
-                if (pe < 0 || 
-                    edges[pe].source != cycle[i] || 
-                    edges[pe].destination != toNode) {
-                    edgesOk = false;
-                    break;
-                }
-                cycleEdgeIdx.push_back(pe);
-            }
-            
-            if (!edgesOk) continue;
-
-            double profit = 1.0;
-            for (int pe : cycleEdgeIdx) {
-                double p = edges[pe].price;
-                if (!std::isfinite(p) || p <= 0.0) {
-                    profit = std::numeric_limits<double>::quiet_NaN();
-                    break;
-                }
-                profit *= p;
-                if (!std::isfinite(profit)) break;
-            }
-
-            if (!std::isfinite(profit)) continue;
-            if (profit <= 0.0 || profit > PROFIT_MAX_LOCAL) continue;
-            if ((int)cycle.size() < MIN_CYCLE_LEN) continue;
-            if (profit < PROFIT_MIN_LOCAL) continue;
-
-            std::string sig = canonicalSignature(cycle, profit);
-            if (isDuplicateCycle(sig)) continue;
-
-            std::ostringstream path;
-            for (int nidx : cycle) {
-                path << nodeNames[nidx] << " -> ";
-            }
-            path << nodeNames[cycle.front()];
-
-            std::time_t ts = clock_wall::to_time_t(clock_wall::now());
-            std::tm ts_tm = *std::localtime(&ts);
-            
-            std::ostringstream pss;
-            pss << std::fixed << std::setprecision(10) << profit;
-
-            std::cout << "[SuperSource] [" << std::put_time(&ts_tm, "%Y-%m-%d %H:%M:%S") << "] "
-                      << "[!] Arbitrage found! Profit = " << pss.str()
-                      << "x | Path: " << path.str() << "\n";
-
-            foundThisSecond++;
-        }
-    }
+    rebuildCertificate();
 }
 
 void Graph::findArbitrageQuiet(BenchmarkStats& stats) {
     const int V = static_cast<int>(nodeNames.size());
     if (V == 0) return;
 
-    static constexpr double RELAX_EPS = 1e-9;
-    static constexpr double PROFIT_MIN_LOCAL = 1.005;
-    static constexpr double PROFIT_MAX_LOCAL = 10.0;
+    std::vector<double> dist;
+    std::vector<int> parent;
+    std::vector<int> parentEdge;
+    std::vector<DetectedCycle> found;
 
-    for (int start = 0; start < V; ++start) {
-        auto startTime = std::chrono::high_resolution_clock::now();
-        
-        std::vector<double> dist(V, std::numeric_limits<double>::infinity());
-        std::vector<int> parent(V, -1);
-        std::vector<int> parentEdge(V, -1);
-        dist[start] = 0.0;
-
-        stats.bellmanFordRuns++;
+    ensureCsr();
+    ensureScc();
 
-        for (int i = 0; i < V - 1; ++i) {
-            for (int ei = 0; ei < (int)edges.size(); ++ei) {
-                const auto& e = edges[ei];
-                stats.edgesProcessed++;
-                
-                if (dist[e.source] != std::numeric_limits<double>::infinity() &&
-                    dist[e.source] + e.weight < dist[e.destination]) {
-                    dist[e.destination] = dist[e.source] + e.weight;
-                    parent[e.destination] = e.source;
-                    parentEdge[e.destination] = ei;
-                }
-            }
-        }
+    if (relaxKernel == RelaxKernel::BellmanFord) {
+        // RELAX_BATCH sources of one component share every edge sweep.
+        sourceCycles.resize(V);
+        for (int c = 0; c + 1 < static_cast<int>(sccNodeStart.size()); ++c) {
+            for (int i = sccNodeStart[c]; i < sccNodeStart[c + 1]; i += RELAX_BATCH) {
+                const int count = std::min(RELAX_BATCH, sccNodeStart[c + 1] - i);
+                const int32_t* sources = sccNodes.data() + i;
 
-        for (int ei = 0; ei < (int)edges.size(); ++ei) {
-            const auto& e = edges[ei];
-            
-            if (dist[e.source] != std::numeric_limits<double>::infinity() &&
-                dist[e.source] + e.weight < dist[e.destination] - RELAX_EPS) {
-                
-                parent[e.destination] = e.source;
-                parentEdge[e.destination] = ei;
-                
-                int v = e.destination;
-                for (int i = 0; i < V; ++i) {
-                    v = parent[v];
-                }
+                auto startTime = std::chrono::high_resolution_clock::now();
 
-                std::vector<int> cycle;
-                int cur = v;
-                do {
-                    cycle.push_back(cur);
-                    cur = parent[cur];
-                } while (cur != v && cur != -1);
-                
-                if (cycle.empty()) continue;
-                std::reverse(cycle.begin(), cycle.end());
+                stats.bellmanFordRuns += count;
 
-                const int n = (int)cycle.size();
-                std::vector<int> cycleEdgeIdx;
-                cycleEdgeIdx.reserve(n);
-                bool edgesOk = true;
-                
-                for (int i = 0; i < n; ++i) {
-                    int toNode = cycle[(i + 1) % n];
-                    int pe = parentEdge[toNode];
-                    
-                    if (pe < 0 || 
-                        edges[pe].source != cycle[i] || 
-                        edges[pe].destination != toNode) {
-                        edgesOk = false;
-                        break;
+                for (int b = 0; b < count; ++b) sourceCycles[sources[b]].clear();
+                stats.addRun(runBatch(sources, count, c, dist, parent, parentEdge, ks));
+                for (int b = 0; b < count; ++b) {
+                    for (const auto& fc : sourceCycles[sources[b]]) {
+                        if (!isDuplicateCycle(canonicalSignature(fc.nodes, fc.profit)))
+                            stats.cyclesFound++;
                     }
-                    cycleEdgeIdx.push_back(pe);
                 }
-                
-                if (!edgesOk) continue;
 
-                double profit = 1.0;
-                for (int pe : cycleEdgeIdx) {
-                    double p = edges[pe].price;
-                    if (!std::isfinite(p) || p <= 0.0) {
-                        profit = std::numeric_limits<double>::quiet_NaN();
-                        break;
-                    }
-                    profit *= p;
-                    if (!std::isfinite(profit)) break;
-                }
+                auto endTime = std::chrono::high_resolution_clock::now();
+                stats.totalTime += std::chrono::duration<double>(endTime - startTime).count();
+            }
+        }
+        return;
+    }
 
-                if (!std::isfinite(profit)) continue;
-                if (profit <= 0.0 || profit > PROFIT_MAX_LOCAL) continue;
-                if ((int)cycle.size() < MIN_CYCLE_LEN) continue;
-                if (profit < PROFIT_MIN_LOCAL) continue;
+    for (int start = 0; start < V; ++start) {
+        if (sccOf[start] < 0) continue;
 
-                std::string sig = canonicalSignature(cycle, profit);
-                if (isDuplicateCycle(sig)) continue;
+        auto startTime = std::chrono::high_resolution_clock::now();
 
-                stats.cyclesFound++;
-            }
-        }
+        stats.bellmanFordRuns++;
+
+        found.clear();
+        stats.addRun(runKernel(start, dist, parent, parentEdge, found, ks, true, sccOf[start]));
+        stats.cyclesFound += static_cast<int>(found.size());
 
         auto endTime = std::chrono::high_resolution_clock::now();
         stats.totalTime += std::chrono::duration<double>(endTime - startTime).count();
@@ -635,103 +2768,22 @@ void Graph::findArbitrageSuperSourceQuiet(BenchmarkStats& stats) {
     const int V = static_cast<int>(nodeNames.size());
     if (V == 0) return;
     
-    ensureSuperSourceEdges();
+    ensureSuperSource();
     if (superSourceId < 0 || superSourceId >= V) return;
 
-    static constexpr double RELAX_EPS = 1e-9;
-    static constexpr double PROFIT_MIN_LOCAL = 1.005;
-    static constexpr double PROFIT_MAX_LOCAL = 10.0;
+    std::vector<double> dist;
+    std::vector<int> parent;
+    std::vector<int> parentEdge;
+    std::vector<DetectedCycle> found;
 
     auto bellmanFord = [&](int startNode) {
         auto startTime = std::chrono::high_resolution_clock::now();
-        
-        std::vector<double> dist(V, std::numeric_limits<double>::infinity());
-        std::vector<int> parent(V, -1);
-        std::vector<int> parentEdge(V, -1);
-        dist[startNode] = 0.0;
 
         stats.bellmanFordRuns++;
 
-        for (int i = 0; i < V - 1; ++i) {
-            for (int ei = 0; ei < (int)edges.size(); ++ei) {
-                const auto& e = edges[ei];
-                stats.edgesProcessed++;
-                
-                if (dist[e.source] != std::numeric_limits<double>::infinity() &&
-                    dist[e.source] + e.weight < dist[e.destination]) {
-                    dist[e.destination] = dist[e.source] + e.weight;
-                    parent[e.destination] = e.source;
-                    parentEdge[e.destination] = ei;
-                }
-            }
-        }
-
-        for (int ei = 0; ei < (int)edges.size(); ++ei) {
-            const auto& e = edges[ei];
-            
-            if (dist[e.source] != std::numeric_limits<double>::infinity() &&
-                dist[e.source] + e.weight < dist[e.destination] - RELAX_EPS) {
-                
-                parent[e.destination] = e.source;
-                parentEdge[e.destination] = ei;
-                
-                int v = e.destination;
-                for (int i = 0; i < V; ++i) {
-                    v = parent[v];
-                }
-
-                std::vector<int> cycle;
-                int cur = v;
-                do {
-                    cycle.push_back(cur);
-                    cur = parent[cur];
-                } while (cur != v && cur != -1);
-                
-                if (cycle.empty()) continue;
-                std::reverse(cycle.begin(), cycle.end());
-
-                const int n = (int)cycle.size();
-                std::vector<int> cycleEdgeIdx;
-                cycleEdgeIdx.reserve(n);
-                bool edgesOk = true;
-                
-                for (int i = 0; i < n; ++i) {
-                    int toNode = cycle[(i + 1) % n];
-                    int pe = parentEdge[toNode];
-                    
-                    if (pe < 0 || 
-                        edges[pe].source != cycle[i] || 
-                        edges[pe].destination != toNode) {
-                        edgesOk = false;
-                        break;
-                    }
-                    cycleEdgeIdx.push_back(pe);
-                }
-                
-                if (!edgesOk) continue;
-
-                double profit = 1.0;
-                for (int pe : cycleEdgeIdx) {
-                    double p = edges[pe].price;
-                    if (!std::isfinite(p) || p <= 0.0) {
-                        profit = std::numeric_limits<double>::quiet_NaN();
-                        break;
-                    }
-                    profit *= p;
-                    if (!std::isfinite(profit)) break;
-                }
-
-                if (!std::isfinite(profit)) continue;
-                if (profit <= 0.0 || profit > PROFIT_MAX_LOCAL) continue;
-                if ((int)cycle.size() < MIN_CYCLE_LEN) continue;
-                if (profit < PROFIT_MIN_LOCAL) continue;
-
-                std::string sig = canonicalSignature(cycle, profit);
-                if (isDuplicateCycle(sig)) continue;
-
-                stats.cyclesFound++;
-            }
-        }
+        found.clear();
+        stats.addRun(runKernel(startNode, dist, parent, parentEdge, found));
+        stats.cyclesFound += static_cast<int>(found.size());
 
         auto endTime = std::chrono::high_resolution_clock::now();
         stats.totalTime += std::chrono::duration<double>(endTime - startTime).count();
@@ -739,25 +2791,62 @@ void Graph::findArbitrageSuperSourceQuiet(BenchmarkStats& stats) {
 
     bellmanFord(superSourceId);
 
-    std::set<std::string> processedExchanges;
+    std::set<int> processedExchanges;
     
     for (int node = 0; node < V; ++node) {
         if (node == superSourceId) continue;
         
-        std::string nodeName = nodeNames[node];
-        std::string exchange = "";
-        
-        if (nodeName.find("_Binance") != std::string::npos) exchange = "Binance";
-        else if (nodeName.find("_OKX") != std::string::npos) exchange = "OKX";
-        else if (nodeName.find("_Bybit") != std::string::npos) exchange = "Bybit";
-        
-if (exchange.empty() || processedExchanges.count(exchange)) continue;
+        int exchange = nodeExchange[node];
+        if (exchange == NO_EXCHANGE || exchange == crossExchangeId ||
+            processedExchanges.count(exchange)) continue;
         
         processedExchanges.insert(exchange);
         bellmanFord(node);
     }
 }
 
+void Graph::findMinMeanCycleQuiet(BenchmarkStats& stats) {
+    if (nodeNames.empty()) return;
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    const int iterations = runHoward();
+    stats.policyIterations += iterations;
+    stats.edgesProcessed += static_cast<long long>(iterations) * edges.size();
+
+    double profit = 0.0;
+    if (howard.bestMean < -RELAX_EPS && acceptCycle(howard.cycle, howard.cycleEdges, profit))
+        stats.cyclesFound++;
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.totalTime += std::chrono::duration<double>(endTime - startTime).count();
+}
+
+void Graph::findTropicalQuiet(BenchmarkStats& stats) {
+    if (nodeNames.empty()) return;
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    computeTropicalPowers();
+    stats.matrixProducts += tropical.maxLen - 1;
+
+    std::vector<DetectedCycle> found;
+    collectTropicalCycles(found);
+    stats.cyclesFound += static_cast<int>(found.size());
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.totalTime += std::chrono::duration<double>(endTime - startTime).count();
+}
+
+void Graph::printRelaxPasses(const BenchmarkStats& stats) const
+{
+    if (stats.relaxPassBound == 0) return;             // queue kernel: no passes
+    std::cout << "  Relax passes:       " << stats.relaxPasses << " of " << stats.relaxPassBound
+              << " (avg " << std::fixed << std::setprecision(1)
+              << (double)stats.relaxPasses / std::max(1, stats.bellmanFordRuns)
+              << "/run, max " << stats.maxRelaxPasses << ")\n";
+}
+
 void Graph::runBenchmark() {
     using clock_steady = std::chrono::steady_clock;
     
@@ -766,6 +2855,11 @@ void Graph::runBenchmark() {
     static auto warmupStart = clock_steady::now();
     static int lastWarmupSec = -1;
     
+    if (!warmupDone && warmStarted) {
+        warmupDone = true;
+        std::cout << "[Benchmark] Graph restored from snapshot. Starting benchmark...\n\n";
+    }
+
     if (!warmupDone) {
         auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
             clock_steady::now() - warmupStart).count();
@@ -796,6 +2890,12 @@ void Graph::runBenchmark() {
     
     static std::deque<std::string> cacheSuper;
     static std::unordered_set<std::string> setSuper;
+
+    static std::deque<std::string> cacheHoward;
+    static std::unordered_set<std::string> setHoward;
+
+    static std::deque<std::string> cacheTropical;
+    static std::unordered_set<std::string> setTropical;
     
     auto backupCache = recentCycles;
     auto backupSet = recentSet;
@@ -825,6 +2925,34 @@ void Graph::runBenchmark() {
     recentCycles = backupCache;
     recentSet = backupSet;
     
+    backupCache = recentCycles;
+    backupSet = recentSet;
+    
+    recentCycles = cacheHoward;
+    recentSet = setHoward;
+    
+    findMinMeanCycleQuiet(statsHoward);
+    
+    cacheHoward = recentCycles;
+    setHoward = recentSet;
+    
+    recentCycles = backupCache;
+    recentSet = backupSet;
+    
+    backupCache = recentCycles;
+    backupSet = recentSet;
+    
+    recentCycles = cacheTropical;
+    recentSet = setTropical;
+    
+    findTropicalQuiet(statsTropical);
+    
+    cacheTropical = recentCycles;
+    setTropical = recentSet;
+    
+    recentCycles = backupCache;
+    recentSet = backupSet;
+    
     iterations++;
 
     auto now = clock_steady::now();
@@ -850,6 +2978,8 @@ void Graph::runBenchmark() {
         std::cout << "  Cycles found:       " << statsClassic.cyclesFound << "\n";
         std::cout << "  Bellman-Ford runs:  " << statsClassic.bellmanFordRuns << "\n";
         std::cout << "  Edges processed:    " << statsClassic.edgesProcessed << "\n";
+        printRelaxPasses(statsClassic);
+        printSccStats("  ");
         std::cout << "  Total time:         " << std::fixed << std::setprecision(3) 
                   << statsClassic.totalTime << "s\n";
         std::cout << "  Avg time/iteration: " << std::fixed << std::setprecision(3)
@@ -859,11 +2989,29 @@ void Graph::runBenchmark() {
         std::cout << "  Cycles found:       " << statsSuper.cyclesFound << "\n";
         std::cout << "  Bellman-Ford runs:  " << statsSuper.bellmanFordRuns << "\n";
         std::cout << "  Edges processed:    " << statsSuper.edgesProcessed << "\n";
+        printRelaxPasses(statsSuper);
         std::cout << "  Total time:         " << std::fixed << std::setprecision(3) 
                   << statsSuper.totalTime << "s\n";
         std::cout << "  Avg time/iteration: " << std::fixed << std::setprecision(3)
                   << (statsSuper.totalTime / iterations) << "s\n\n";
         
+        std::cout << "[Min-Mean Cycle - Howard Policy Iteration]\n";
+        std::cout << "  Cycles found:       " << statsHoward.cyclesFound << "\n";
+        std::cout << "  Policy iterations:  " << statsHoward.policyIterations << "\n";
+        std::cout << "  Edges processed:    " << statsHoward.edgesProcessed << "\n";
+        std::cout << "  Total time:         " << std::fixed << std::setprecision(3) 
+                  << statsHoward.totalTime << "s\n";
+        std::cout << "  Avg time/iteration: " << std::fixed << std::setprecision(6)
+                  << (statsHoward.totalTime / iterations) << "s\n\n";
+        
+        std::cout << "[Tropical - Min-Plus Powers up to " << tropical.maxLen << " Edges]\n";
+        std::cout << "  Cycles found:       " << statsTropical.cyclesFound << "\n";
+        std::cout << "  Matrix products:    " << statsTropical.matrixProducts << "\n";
+        std::cout << "  Total time:         " << std::fixed << std::setprecision(3) 
+                  << statsTropical.totalTime << "s\n";
+        std::cout << "  Avg time/iteration: " << std::fixed << std::setprecision(6)
+                  << (statsTropical.totalTime / iterations) << "s\n\n";
+        
         if (statsSuper.totalTime > 0) {
             double speedup = statsClassic.totalTime / statsSuper.totalTime;
             std::cout << "Performance:\n";
@@ -882,11 +3030,65 @@ void Graph::runBenchmark() {
         iterations = 0;
         statsClassic = BenchmarkStats();
         statsSuper = BenchmarkStats();
+        statsHoward = BenchmarkStats();
+        statsTropical = BenchmarkStats();
         
         cacheClassic.clear();
         setClassic.clear();
         cacheSuper.clear();
         setSuper.clear();
+        cacheHoward.clear();
+        setHoward.clear();
+        cacheTropical.clear();
+        setTropical.clear();
+    }
+}
+
+void Graph::runSyntheticBenchmark(int maxNodes) const
+{
+    static const int SYNTHETIC_DEGREE = 8;         // markets quoted per asset
+    static const double SYNTHETIC_SPREAD = 0.003;  // max relative price noise per market
+
+    std::vector<int> sizes;
+    for (int n : {100, 250, 500, 1000})
+        if (n < maxNodes) sizes.push_back(n);
+    sizes.push_back(maxNodes);
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> logPrice(-5.0, 5.0);
+    std::uniform_real_distribution<double> noise(-SYNTHETIC_SPREAD, SYNTHETIC_SPREAD);
+
+    std::cout << "[Synthetic Benchmark] " << SYNTHETIC_DEGREE << " markets per asset, one exchange, "
+              << "cycles up to " << std::max(MIN_CYCLE_LEN, shortCycles.maxLen) << " edges for Tropical\n";
+    for (int V : sizes) {
+        Graph g;
+        g.relaxKernel = relaxKernel;
+        g.simdLevel = simdLevel;
+        g.detectionThreads = detectionThreads;
+        g.shortCycles.maxLen = shortCycles.maxLen;
+
+        std::vector<double> lp(V);
+        for (double& x : lp) x = logPrice(rng);
+        std::uniform_int_distribution<int> pick(0, V - 1);
+        for (int a = 0; a < V; ++a) {
+            for (int d = 0; d < SYNTHETIC_DEGREE; ++d) {
+                const int b = pick(rng);
+                if (b == a) continue;
+                const std::string base = "S" + std::to_string(a);
+                const std::string quote = "S" + std::to_string(b);
+                g.addOrUpdateEdge(base + "_SYN", quote + "_SYN", std::exp(lp[a] - lp[b]) * (1.0 + noise(rng)),
+                                  "SYN", base + quote);
+            }
+        }
+
+        BenchmarkStats classic, tropicalStats;
+        g.findArbitrageQuiet(classic);
+        g.findTropicalQuiet(tropicalStats);
+
+        std::cout << "  " << std::setw(5) << V << " nodes, " << std::setw(6) << g.edges.size() << " edges | "
+                  << "Classic " << std::fixed << std::setprecision(4) << classic.totalTime << "s ("
+                  << classic.cyclesFound << " cycles) | Tropical " << tropicalStats.totalTime << "s ("
+                  << tropicalStats.cyclesFound << " cycles, " << tropicalStats.matrixProducts << " products)\n";
     }
 }
 
@@ -930,14 +3132,12 @@ void Graph::logArbitrageToCSV(const std::vector<int>& cycle, double profit) {
     bool isCross = false;
     
     for (size_t i = 0; i < cycle.size(); ++i) {
-        std::string nodeName = nodeNames[cycle[i]];
-        path << nodeName;
+        path << nodeNames[cycle[i]];
         if (i < cycle.size() - 1) path << " -> ";
         
-        size_t pos = nodeName.find('_');
-        if (pos != std::string::npos) {
-            std::string exchange = nodeName.substr(pos + 1);
-            uniqueExchanges.insert(exchange);
+        int exchange = nodeExchange[cycle[i]];
+        if (exchange != NO_EXCHANGE) {
+            uniqueExchanges.insert(exchangeNames[exchange]);
         }
     }
     path << " -> " << nodeNames[cycle[0]];
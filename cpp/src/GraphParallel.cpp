@@ -0,0 +1,105 @@
+#include "Graph.h"
+
+WorkerPool::WorkerPool(int n)
+{
+    threads.reserve(n);
+    for (int i = 0; i < n; ++i) threads.emplace_back(&WorkerPool::loop, this, i);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : threads) t.join();
+}
+
+void WorkerPool::run(const std::function<void(int)>& fn)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    job = &fn;
+    running = size();
+    ++generation;
+    wake.notify_all();
+    done.wait(lock, [this] { return running == 0; });
+    job = nullptr;
+}
+
+void WorkerPool::loop(int worker)
+{
+    uint64_t seen = 0;
+    while (true) {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [&] { return stopping || generation != seen; });
+        if (stopping) return;
+        seen = generation;
+        const auto* fn = job;
+        lock.unlock();
+
+        (*fn)(worker);
+
+        lock.lock();
+        if (--running == 0) done.notify_one();
+    }
+}
+
+void Graph::ensurePool()
+{
+    if (detectionThreads > 1 && (!pool || pool->size() != detectionThreads)) {
+        pool.reset();
+        pool = std::make_unique<WorkerPool>(detectionThreads);
+    }
+}
+
+void Graph::collectSources()
+{
+    const int V = static_cast<int>(nodeNames.size());
+
+    // Everything the workers read (CSR, components) is built by the caller.
+    ensurePool();
+    workerScratch.resize(detectionThreads);
+    sourceCycles.resize(V);
+    for (auto& list : sourceCycles) list.clear();
+
+    // Bellman-Ford takes up to RELAX_BATCH sources of one component per
+    // task, the queue kernel one source. Tasks of different components
+    // never share state, so one shared counter keeps every worker busy.
+    // Components the float32 screen cleared get no tasks.
+    struct Task {
+        const int32_t* sources;
+        int count;
+    };
+    std::vector<Task> tasks;
+    const bool batched = relaxKernel == RelaxKernel::BellmanFord;
+    if (batched) {
+        for (int c = 0; c + 1 < static_cast<int>(sccNodeStart.size()); ++c) {
+            if (screen.cleared[c]) continue;
+            for (int i = sccNodeStart[c]; i < sccNodeStart[c + 1]; i += RELAX_BATCH)
+                tasks.push_back({sccNodes.data() + i, std::min(RELAX_BATCH, sccNodeStart[c + 1] - i)});
+        }
+    } else {
+        for (const int32_t& start : cyclicNodes) {
+            if (!screen.cleared[sccOf[start]]) tasks.push_back({&start, 1});
+        }
+    }
+
+    const int taskCount = static_cast<int>(tasks.size());
+    std::atomic<int> nextTask{0};
+    auto work = [&](int worker) {
+        auto& ws = workerScratch[worker];
+        for (int t; (t = nextTask.fetch_add(1, std::memory_order_relaxed)) < taskCount; ) {
+            const Task& task = tasks[t];
+            const int start = task.sources[0];
+            if (batched) {
+                runBatch(task.sources, task.count, sccOf[start], ws.dist, ws.parent, ws.parentEdge, ws.q);
+            } else {
+                runKernel(start, ws.dist, ws.parent, ws.parentEdge, sourceCycles[start],
+                          ws.q, false, sccOf[start]);
+            }
+        }
+    };
+    if (pool && detectionThreads > 1) pool->run(work);
+    else work(0);
+}
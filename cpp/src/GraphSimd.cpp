@@ -0,0 +1,546 @@
+#include "Graph.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define GRAPH_X86_SIMD 1
+#endif
+
+namespace {
+
+inline void lower(const RelaxSpan& s, int u, int k, double cand, int pass)
+{
+    const int v = s.dst[k];
+    s.dist[v] = cand;
+    s.parent[v] = u;
+    s.parentEdge[v] = s.ids[k];
+    s.lastPass[v] = pass;
+}
+
+// Edge-by-edge pass over edge slots [begin, end) out of u: the reference
+// the SIMD paths must match, and their tail loop.
+inline bool relaxRun(const RelaxSpan& s, int u, double du, int begin, int end, int pass)
+{
+    bool lowered = false;
+    for (int k = begin; k < end; ++k) {
+        const double cand = du + s.weight[k];
+        if (cand < s.dist[s.dst[k]] - s.eps) {
+            lower(s, u, k, cand, pass);
+            lowered = true;
+        }
+    }
+    return lowered;
+}
+
+// Every pass walks the span's nodes in order and skips those not lowered
+// since their out-edges were last scanned (or never reached at all).
+template <typename Span, typename ScanOut>
+long long relaxNodes(const Span& s, int pass, bool& lowered, ScanOut scanOut)
+{
+    long long scanned = 0;
+    for (int i = 0; i < s.nodeCount; ++i) {
+        const int u = s.nodes ? s.nodes[i] : i;
+        if (s.lastPass[u] < pass - 1) continue;
+        const int begin = s.outStart[i];
+        const int end = s.outStart[i + 1];
+        scanned += end - begin;
+        if (scanOut(u, begin, end)) lowered = true;
+    }
+    return scanned;
+}
+
+long long relaxScalar(const RelaxSpan& s, int pass, bool& lowered)
+{
+    return relaxNodes(s, pass, lowered, [&](int u, int begin, int end) {
+        return relaxRun(s, u, s.dist[u], begin, end, pass);
+    });
+}
+
+// --- Batched passes: lane b of node n lives at n * RELAX_BATCH + b ---
+
+inline void lowerLane(const RelaxSpan& s, int u, int k, int lane, double cand, int pass)
+{
+    const int v = s.dst[k];
+    const size_t cell = static_cast<size_t>(v) * RELAX_BATCH + lane;
+    s.dist[cell] = cand;
+    s.parent[cell] = u;
+    s.parentEdge[cell] = s.ids[k];
+    s.lastPass[v] = pass;
+}
+
+bool relaxBatchOutScalar(const RelaxSpan& s, int u, int begin, int end, int pass)
+{
+    const double* du = s.dist + static_cast<size_t>(u) * RELAX_BATCH;
+    bool lowered = false;
+    for (int k = begin; k < end; ++k) {
+        const double* dv = s.dist + static_cast<size_t>(s.dst[k]) * RELAX_BATCH;
+        for (int b = 0; b < RELAX_BATCH; ++b) {
+            const double cand = du[b] + s.weight[k];
+            if (cand < dv[b] - s.eps) {
+                lowerLane(s, u, k, b, cand, pass);
+                lowered = true;
+            }
+        }
+    }
+    return lowered;
+}
+
+// --- Float32 screening passes ---
+
+inline bool screenRun(const ScreenSpan& s, float du, int begin, int end, int pass)
+{
+    bool lowered = false;
+    for (int k = begin; k < end; ++k) {
+        const float cand = du + s.weight[k];
+        if (cand < s.dist[s.dst[k]]) {
+            s.dist[s.dst[k]] = cand;
+            s.lastPass[s.dst[k]] = pass;
+            lowered = true;
+        }
+    }
+    return lowered;
+}
+
+// --- Min-plus products: row m of b folded into row i of c, one tile wide ---
+
+// Walks the (i, m, j) tiles and hands each (i, m) pair with a finite
+// a[i][m] to foldRow, which covers the MINPLUS_TILE columns from j0.
+template <typename FoldRow>
+void minPlusTiles(const MinPlusSpan& s, FoldRow foldRow)
+{
+    for (int i0 = 0; i0 < s.n; i0 += MINPLUS_TILE) {
+        const int iEnd = std::min(s.n, i0 + MINPLUS_TILE);
+        for (int m0 = 0; m0 < s.n; m0 += MINPLUS_TILE) {
+            const int mEnd = std::min(s.n, m0 + MINPLUS_TILE);
+            for (int j0 = 0; j0 < s.n; j0 += MINPLUS_TILE) {
+                for (int i = i0; i < iEnd; ++i) {
+                    const double* ai = s.a + static_cast<size_t>(i) * s.stride;
+                    double* ci = s.c + static_cast<size_t>(i) * s.stride + j0;
+                    int32_t* argi = s.arg + static_cast<size_t>(i) * s.stride + j0;
+                    for (int m = m0; m < mEnd; ++m) {
+                        if (ai[m] == std::numeric_limits<double>::infinity()) continue;
+                        foldRow(ci, argi, s.b + static_cast<size_t>(m) * s.stride + j0, ai[m], m);
+                    }
+                }
+            }
+        }
+    }
+}
+
+inline void minPlusRowScalar(double* ci, int32_t* argi, const double* bm, double aim, int m)
+{
+    for (int j = 0; j < MINPLUS_TILE; ++j) {
+        const double cand = aim + bm[j];
+        if (cand < ci[j]) {
+            ci[j] = cand;
+            argi[j] = m;
+        }
+    }
+}
+
+// --- Fixed-point layers: one int32 tick sum per node ---
+
+inline void reachTick(const TickLayerSpan& s, int k, int32_t cand)
+{
+    const int y = s.dst[k];
+    if (s.next[y] == TICK_INF) s.reached->push_back(y);
+    s.next[y] = cand;
+    s.pred[y] = s.ids[k];
+}
+
+inline void tickRun(const TickLayerSpan& s, int32_t from, int begin, int end)
+{
+    for (int k = begin; k < end; ++k) {
+        const int32_t cand = from + s.ticks[k];
+        if (s.dst[k] >= s.floor && cand < s.next[s.dst[k]]) reachTick(s, k, cand);
+    }
+}
+
+template <typename ScanOut>
+void tickFrontier(const TickLayerSpan& s, ScanOut scanOut)
+{
+    for (int i = 0; i < s.frontierCount; ++i) {
+        const int x = s.frontier[i];
+        scanOut(s.prev[x], s.outStart[x], s.outStart[x + 1]);
+    }
+}
+
+#ifdef GRAPH_X86_SIMD
+
+static_assert(RELAX_BATCH == 8, "batched SIMD passes assume 8 lanes");
+static_assert(MINPLUS_TILE % 16 == 0, "min-plus SIMD rows step 16 columns");
+
+__attribute__((target("avx2")))
+void minPlusRowAvx2(double* ci, int32_t* argi, const double* bm, double aim, int m)
+{
+    const __m256d from = _mm256_set1_pd(aim);
+    const __m128i via = _mm_set1_epi32(m);
+    const __m256i low32 = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    for (int j = 0; j < MINPLUS_TILE; j += 4) {
+        const __m256d cand = _mm256_add_pd(from, _mm256_loadu_pd(bm + j));
+        const __m256d cur = _mm256_loadu_pd(ci + j);
+        const __m256d better = _mm256_cmp_pd(cand, cur, _CMP_LT_OQ);
+        _mm256_storeu_pd(ci + j, _mm256_blendv_pd(cur, cand, better));
+
+        // Narrow the 64-bit lane mask to the four 32-bit arg lanes.
+        const __m128i better32 = _mm256_castsi256_si128(
+            _mm256_permutevar8x32_epi32(_mm256_castpd_si256(better), low32));
+        const __m128i args = _mm_loadu_si128(reinterpret_cast<const __m128i*>(argi + j));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(argi + j), _mm_blendv_epi8(args, via, better32));
+    }
+}
+
+__attribute__((target("avx512f")))
+void minPlusRowAvx512(double* ci, int32_t* argi, const double* bm, double aim, int m)
+{
+    const __m512d from = _mm512_set1_pd(aim);
+    const __m512i via = _mm512_set1_epi32(m);
+    for (int j = 0; j < MINPLUS_TILE; j += 16) {
+        const __m512d candLo = _mm512_add_pd(from, _mm512_loadu_pd(bm + j));
+        const __m512d candHi = _mm512_add_pd(from, _mm512_loadu_pd(bm + j + 8));
+        const __m512d curLo = _mm512_loadu_pd(ci + j);
+        const __m512d curHi = _mm512_loadu_pd(ci + j + 8);
+        const __mmask8 lo = _mm512_cmp_pd_mask(candLo, curLo, _CMP_LT_OQ);
+        const __mmask8 hi = _mm512_cmp_pd_mask(candHi, curHi, _CMP_LT_OQ);
+        if (!(lo | hi)) continue;
+
+        _mm512_storeu_pd(ci + j, _mm512_mask_mov_pd(curLo, lo, candLo));
+        _mm512_storeu_pd(ci + j + 8, _mm512_mask_mov_pd(curHi, hi, candHi));
+        const __m512i args = _mm512_loadu_si512(argi + j);
+        _mm512_storeu_si512(argi + j, _mm512_mask_mov_epi32(args, static_cast<__mmask16>(lo | hi << 8), via));
+    }
+}
+
+__attribute__((target("avx2")))
+bool relaxBatchOutAvx2(const RelaxSpan& s, int u, int begin, int end, int pass)
+{
+    const double* du = s.dist + static_cast<size_t>(u) * RELAX_BATCH;
+    const __m256d fromLo = _mm256_loadu_pd(du);
+    const __m256d fromHi = _mm256_loadu_pd(du + 4);
+    const __m256d eps = _mm256_set1_pd(s.eps);
+    bool lowered = false;
+
+    for (int k = begin; k < end; ++k) {
+        const double* dv = s.dist + static_cast<size_t>(s.dst[k]) * RELAX_BATCH;
+        const __m256d w = _mm256_set1_pd(s.weight[k]);
+        const __m256d candLo = _mm256_add_pd(fromLo, w);
+        const __m256d candHi = _mm256_add_pd(fromHi, w);
+        const __m256d boundLo = _mm256_sub_pd(_mm256_loadu_pd(dv), eps);
+        const __m256d boundHi = _mm256_sub_pd(_mm256_loadu_pd(dv + 4), eps);
+        int better = _mm256_movemask_pd(_mm256_cmp_pd(candLo, boundLo, _CMP_LT_OQ)) |
+                     _mm256_movemask_pd(_mm256_cmp_pd(candHi, boundHi, _CMP_LT_OQ)) << 4;
+        if (!better) continue;
+
+        alignas(32) double c[8];
+        _mm256_store_pd(c, candLo);
+        _mm256_store_pd(c + 4, candHi);
+        for (; better; better &= better - 1) {
+            const int lane = __builtin_ctz(better);
+            lowerLane(s, u, k, lane, c[lane], pass);
+        }
+        lowered = true;
+    }
+    return lowered;
+}
+
+__attribute__((target("avx512f")))
+bool relaxBatchOutAvx512(const RelaxSpan& s, int u, int begin, int end, int pass)
+{
+    const __m512d from = _mm512_loadu_pd(s.dist + static_cast<size_t>(u) * RELAX_BATCH);
+    const __m512d eps = _mm512_set1_pd(s.eps);
+    bool lowered = false;
+
+    for (int k = begin; k < end; ++k) {
+        const double* dv = s.dist + static_cast<size_t>(s.dst[k]) * RELAX_BATCH;
+        const __m512d cand = _mm512_add_pd(from, _mm512_set1_pd(s.weight[k]));
+        const __m512d bound = _mm512_sub_pd(_mm512_loadu_pd(dv), eps);
+        unsigned better = _mm512_cmp_pd_mask(cand, bound, _CMP_LT_OQ);
+        if (!better) continue;
+
+        alignas(64) double c[8];
+        _mm512_store_pd(c, cand);
+        for (; better; better &= better - 1) {
+            const int lane = __builtin_ctz(better);
+            lowerLane(s, u, k, lane, c[lane], pass);
+        }
+        lowered = true;
+    }
+    return lowered;
+}
+
+__attribute__((target("avx2")))
+bool relaxOutAvx2(const RelaxSpan& s, int u, double du, int begin, int end, int pass)
+{
+    const __m256d from = _mm256_set1_pd(du);
+    const __m256d eps = _mm256_set1_pd(s.eps);
+    bool lowered = false;
+
+    int k = begin;
+    for (; k + 4 <= end; k += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s.dst + k));
+        const __m256d cand = _mm256_add_pd(from, _mm256_loadu_pd(s.weight + k));
+        const __m256d bound = _mm256_sub_pd(_mm256_i32gather_pd(s.dist, v, 8), eps);
+        int better = _mm256_movemask_pd(_mm256_cmp_pd(cand, bound, _CMP_LT_OQ));
+        if (!better) continue;
+
+        alignas(32) double c[4];
+        _mm256_store_pd(c, cand);
+        for (; better; better &= better - 1) {
+            const int lane = __builtin_ctz(better);
+            lower(s, u, k + lane, c[lane], pass);
+        }
+        lowered = true;
+    }
+    return relaxRun(s, u, du, k, end, pass) || lowered;
+}
+
+__attribute__((target("avx512f")))
+bool relaxOutAvx512(const RelaxSpan& s, int u, double du, int begin, int end, int pass)
+{
+    const __m512d from = _mm512_set1_pd(du);
+    const __m512d eps = _mm512_set1_pd(s.eps);
+    bool lowered = false;
+
+    int k = begin;
+    for (; k + 8 <= end; k += 8) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.dst + k));
+        const __m512d cand = _mm512_add_pd(from, _mm512_loadu_pd(s.weight + k));
+        const __m512d bound = _mm512_sub_pd(_mm512_i32gather_pd(v, s.dist, 8), eps);
+        unsigned better = _mm512_cmp_pd_mask(cand, bound, _CMP_LT_OQ);
+        if (!better) continue;
+
+        alignas(64) double c[8];
+        _mm512_store_pd(c, cand);
+        for (; better; better &= better - 1) {
+            const int lane = __builtin_ctz(better);
+            lower(s, u, k + lane, c[lane], pass);
+        }
+        lowered = true;
+    }
+    return relaxRun(s, u, du, k, end, pass) || lowered;
+}
+
+__attribute__((target("avx2")))
+void tickOutAvx2(const TickLayerSpan& s, int32_t from, int begin, int end)
+{
+    const __m256i base = _mm256_set1_epi32(from);
+    const __m256i below = _mm256_set1_epi32(s.floor - 1);
+    const int* next = reinterpret_cast<const int*>(s.next);
+
+    int k = begin;
+    for (; k + 8 <= end; k += 8) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.dst + k));
+        const __m256i cand = _mm256_add_epi32(base, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.ticks + k)));
+        const __m256i cur = _mm256_i32gather_epi32(next, v, 4);
+        const __m256i hit = _mm256_and_si256(_mm256_cmpgt_epi32(cur, cand), _mm256_cmpgt_epi32(v, below));
+        int better = _mm256_movemask_ps(_mm256_castsi256_ps(hit));
+        if (!better) continue;
+
+        alignas(32) int32_t c[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(c), cand);
+        for (; better; better &= better - 1) {
+            const int lane = __builtin_ctz(better);
+            reachTick(s, k + lane, c[lane]);
+        }
+    }
+    tickRun(s, from, k, end);
+}
+
+__attribute__((target("avx512f")))
+void tickOutAvx512(const TickLayerSpan& s, int32_t from, int begin, int end)
+{
+    const __m512i base = _mm512_set1_epi32(from);
+    const __m512i floor = _mm512_set1_epi32(s.floor);
+
+    int k = begin;
+    for (; k + 16 <= end; k += 16) {
+        const __m512i v = _mm512_loadu_si512(s.dst + k);
+        const __m512i cand = _mm512_add_epi32(base, _mm512_loadu_si512(s.ticks + k));
+        const __m512i cur = _mm512_i32gather_epi32(v, s.next, 4);
+        unsigned better = _mm512_mask_cmplt_epi32_mask(_mm512_cmpge_epi32_mask(v, floor), cand, cur);
+        if (!better) continue;
+
+        alignas(64) int32_t c[16];
+        _mm512_store_si512(c, cand);
+        for (; better; better &= better - 1) {
+            const int lane = __builtin_ctz(better);
+            reachTick(s, k + lane, c[lane]);
+        }
+    }
+    tickRun(s, from, k, end);
+}
+
+__attribute__((target("avx2")))
+bool screenOutAvx2(const ScreenSpan& s, float du, int begin, int end, int pass)
+{
+    const __m256 from = _mm256_set1_ps(du);
+    bool lowered = false;
+
+    int k = begin;
+    for (; k + 8 <= end; k += 8) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.dst + k));
+        const __m256 cand = _mm256_add_ps(from, _mm256_loadu_ps(s.weight + k));
+        int better = _mm256_movemask_ps(_mm256_cmp_ps(cand, _mm256_i32gather_ps(s.dist, v, 4), _CMP_LT_OQ));
+        if (!better) continue;
+
+        alignas(32) float c[8];
+        _mm256_store_ps(c, cand);
+        for (; better; better &= better - 1) {
+            const int lane = __builtin_ctz(better);
+            s.dist[s.dst[k + lane]] = c[lane];
+            s.lastPass[s.dst[k + lane]] = pass;
+        }
+        lowered = true;
+    }
+    return screenRun(s, du, k, end, pass) || lowered;
+}
+
+__attribute__((target("avx512f")))
+bool screenOutAvx512(const ScreenSpan& s, float du, int begin, int end, int pass)
+{
+    const __m512 from = _mm512_set1_ps(du);
+    bool lowered = false;
+
+    int k = begin;
+    for (; k + 16 <= end; k += 16) {
+        const __m512i v = _mm512_loadu_si512(s.dst + k);
+        const __m512 cand = _mm512_add_ps(from, _mm512_loadu_ps(s.weight + k));
+        unsigned better = _mm512_cmp_ps_mask(cand, _mm512_i32gather_ps(v, s.dist, 4), _CMP_LT_OQ);
+        if (!better) continue;
+
+        alignas(64) float c[16];
+        _mm512_store_ps(c, cand);
+        for (; better; better &= better - 1) {
+            const int lane = __builtin_ctz(better);
+            s.dist[s.dst[k + lane]] = c[lane];
+            s.lastPass[s.dst[k + lane]] = pass;
+        }
+        lowered = true;
+    }
+    return screenRun(s, du, k, end, pass) || lowered;
+}
+
+#endif
+
+} // namespace
+
+SimdLevel detectSimdLevel()
+{
+#ifdef GRAPH_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::Avx512;
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::Avx2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+const char* simdLevelName(SimdLevel level)
+{
+    switch (level) {
+    case SimdLevel::Avx512: return "AVX-512";
+    case SimdLevel::Avx2:   return "AVX2";
+    default:                return "scalar";
+    }
+}
+
+void Graph::setSimdLevel(SimdLevel level)
+{
+    simdLevel = std::min(level, detectSimdLevel());
+}
+
+long long Graph::relaxPass(const RelaxSpan& span, int pass, bool& lowered) const
+{
+    switch (simdLevel) {
+#ifdef GRAPH_X86_SIMD
+    case SimdLevel::Avx512:
+        return relaxNodes(span, pass, lowered, [&](int u, int begin, int end) {
+            return relaxOutAvx512(span, u, span.dist[u], begin, end, pass);
+        });
+    case SimdLevel::Avx2:
+        return relaxNodes(span, pass, lowered, [&](int u, int begin, int end) {
+            return relaxOutAvx2(span, u, span.dist[u], begin, end, pass);
+        });
+#endif
+    default:
+        return relaxScalar(span, pass, lowered);
+    }
+}
+
+long long Graph::relaxBatchPass(const RelaxSpan& span, int pass, bool& lowered) const
+{
+    switch (simdLevel) {
+#ifdef GRAPH_X86_SIMD
+    case SimdLevel::Avx512:
+        return relaxNodes(span, pass, lowered, [&](int u, int begin, int end) {
+            return relaxBatchOutAvx512(span, u, begin, end, pass);
+        });
+    case SimdLevel::Avx2:
+        return relaxNodes(span, pass, lowered, [&](int u, int begin, int end) {
+            return relaxBatchOutAvx2(span, u, begin, end, pass);
+        });
+#endif
+    default:
+        return relaxNodes(span, pass, lowered, [&](int u, int begin, int end) {
+            return relaxBatchOutScalar(span, u, begin, end, pass);
+        });
+    }
+}
+
+long long Graph::screenPass(const ScreenSpan& span, int pass, bool& lowered) const
+{
+    switch (simdLevel) {
+#ifdef GRAPH_X86_SIMD
+    case SimdLevel::Avx512:
+        return relaxNodes(span, pass, lowered, [&](int u, int begin, int end) {
+            return screenOutAvx512(span, span.dist[u], begin, end, pass);
+        });
+    case SimdLevel::Avx2:
+        return relaxNodes(span, pass, lowered, [&](int u, int begin, int end) {
+            return screenOutAvx2(span, span.dist[u], begin, end, pass);
+        });
+#endif
+    default:
+        return relaxNodes(span, pass, lowered, [&](int u, int begin, int end) {
+            return screenRun(span, span.dist[u], begin, end, pass);
+        });
+    }
+}
+
+void Graph::minPlusProduct(const MinPlusSpan& span) const
+{
+    for (int i = 0; i < span.n; ++i) {
+        const size_t row = static_cast<size_t>(i) * span.stride;
+        std::fill(span.c + row, span.c + row + span.stride, std::numeric_limits<double>::infinity());
+        std::fill(span.arg + row, span.arg + row + span.stride, -1);
+    }
+
+    switch (simdLevel) {
+#ifdef GRAPH_X86_SIMD
+    case SimdLevel::Avx512:
+        minPlusTiles(span, minPlusRowAvx512);
+        break;
+    case SimdLevel::Avx2:
+        minPlusTiles(span, minPlusRowAvx2);
+        break;
+#endif
+    default:
+        minPlusTiles(span, minPlusRowScalar);
+        break;
+    }
+}
+
+void Graph::relaxTickLayer(const TickLayerSpan& span) const
+{
+    switch (simdLevel) {
+#ifdef GRAPH_X86_SIMD
+    case SimdLevel::Avx512:
+        tickFrontier(span, [&](int32_t from, int begin, int end) { tickOutAvx512(span, from, begin, end); });
+        break;
+    case SimdLevel::Avx2:
+        tickFrontier(span, [&](int32_t from, int begin, int end) { tickOutAvx2(span, from, begin, end); });
+        break;
+#endif
+    default:
+        tickFrontier(span, [&](int32_t from, int begin, int end) { tickRun(span, from, begin, end); });
+        break;
+    }
+}
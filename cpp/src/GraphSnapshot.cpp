@@ -0,0 +1,450 @@
+#include "Graph.h"
+
+#include <cstring>
+#include <cstdio>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Snapshot file layout (native byte order, every section 8-byte aligned so
+// the arrays can be validated in place in the mapping; the loader rejects
+// a section that is not aligned to its element size). Loading still copies
+// them out: the graph keeps its own vectors and rebuilds the lookup maps and
+// the edge id layout from them, so the mapping is released once loaded.
+//
+//   SnapshotHeader
+//   uint32 stringOffsets[assetCount + exchangeCount + edgeCount + 1]
+//   char   stringBlob[stringBytes]        assets, then exchanges, then market symbols
+//   int32  nodeAsset[nodeCount]
+//   int32  nodeExchange[nodeCount]
+//   int32  edgeSrc[edgeCount]             market base
+//   int32  edgeDst[edgeCount]             market quote
+//   int32  edgeExchange[edgeCount]
+//   double edgePrice[edgeCount]
+//
+// Weights are not stored: the loader derives each as -log(price), so the
+// two cannot disagree.
+//
+// The edge sections hold one record per market (EdgeStore), in insertion
+// order, so reloading them lays the edge ids out as they were. An asset's
+// Cross records each join one node to its bridge group.
+
+static constexpr char SNAPSHOT_MAGIC[8] = {'A', 'R', 'B', 'G', 'R', 'A', 'P', 'H'};
+static constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t assetCount;
+    uint32_t exchangeCount;
+    uint32_t nodeCount;
+    uint32_t edgeCount;
+    uint32_t stringBytes;
+    uint64_t stringOffsetsAt;
+    uint64_t stringBlobAt;
+    uint64_t nodeAssetAt;
+    uint64_t nodeExchangeAt;
+    uint64_t edgeSrcAt;
+    uint64_t edgeDstAt;
+    uint64_t edgeExchangeAt;
+    uint64_t edgePriceAt;
+    uint64_t fileSize;
+};
+
+static uint64_t alignUp(uint64_t n)
+{
+    return (n + 7) & ~static_cast<uint64_t>(7);
+}
+
+// === Read-only file mapping ===
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return;
+        LARGE_INTEGER sz;
+        if (!GetFileSizeEx(file, &sz) || sz.QuadPart == 0) return;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return;
+        data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (data) size = static_cast<size_t>(sz.QuadPart);
+#else
+        fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) return;
+        void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) return;
+        data = static_cast<const char*>(p);
+        size = static_cast<size_t>(st.st_size);
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (data) munmap(const_cast<char*>(data), size);
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data = nullptr;
+    size_t size = 0;
+
+private:
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+bool Graph::saveSnapshot(const std::string& path) const
+{
+    const uint32_t A = static_cast<uint32_t>(assetNames.size());
+    const uint32_t X = static_cast<uint32_t>(exchangeNames.size());
+    const uint32_t V = static_cast<uint32_t>(nodeNames.size());
+    const uint32_t E = static_cast<uint32_t>(edges.markets());
+
+    std::vector<uint32_t> stringOffsets;
+    std::string blob;
+    stringOffsets.reserve(A + X + E + 1);
+    auto addString = [&](const std::string& str) {
+        stringOffsets.push_back(static_cast<uint32_t>(blob.size()));
+        blob += str;
+    };
+    for (const auto& a : assetNames) addString(a);
+    for (const auto& x : exchangeNames) addString(x);
+    for (const auto& sym : edges.marketSymbol) addString(sym);
+    stringOffsets.push_back(static_cast<uint32_t>(blob.size()));
+
+    SnapshotHeader h{};
+    std::memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.version = SNAPSHOT_VERSION;
+    h.assetCount = A;
+    h.exchangeCount = X;
+    h.nodeCount = V;
+    h.edgeCount = E;
+    h.stringBytes = static_cast<uint32_t>(blob.size());
+
+    uint64_t at = alignUp(sizeof(SnapshotHeader));
+    h.stringOffsetsAt = at; at = alignUp(at + stringOffsets.size() * sizeof(uint32_t));
+    h.stringBlobAt    = at; at = alignUp(at + blob.size());
+    h.nodeAssetAt     = at; at = alignUp(at + V * sizeof(int32_t));
+    h.nodeExchangeAt  = at; at = alignUp(at + V * sizeof(int32_t));
+    h.edgeSrcAt       = at; at = alignUp(at + E * sizeof(int32_t));
+    h.edgeDstAt       = at; at = alignUp(at + E * sizeof(int32_t));
+    h.edgeExchangeAt  = at; at = alignUp(at + E * sizeof(int32_t));
+    h.edgePriceAt     = at; at = alignUp(at + E * sizeof(double));
+    h.fileSize = at;
+
+    std::vector<char> buf(static_cast<size_t>(h.fileSize), 0);
+    auto put = [&](uint64_t offset, const void* src, size_t bytes) {
+        if (bytes) std::memcpy(buf.data() + offset, src, bytes);
+    };
+    std::vector<int32_t> nodeAsset32(nodeAsset.begin(), nodeAsset.end());
+    std::vector<int32_t> nodeExchange32(nodeExchange.begin(), nodeExchange.end());
+
+    put(0, &h, sizeof(h));
+    put(h.stringOffsetsAt, stringOffsets.data(), stringOffsets.size() * sizeof(uint32_t));
+    put(h.stringBlobAt, blob.data(), blob.size());
+    put(h.nodeAssetAt, nodeAsset32.data(), V * sizeof(int32_t));
+    put(h.nodeExchangeAt, nodeExchange32.data(), V * sizeof(int32_t));
+    put(h.edgeSrcAt, edges.base.data(), E * sizeof(int32_t));
+    put(h.edgeDstAt, edges.quote.data(), E * sizeof(int32_t));
+    put(h.edgeExchangeAt, edges.marketExchange.data(), E * sizeof(int32_t));
+    put(h.edgePriceAt, edges.marketPrice.data(), E * sizeof(double));
+
+    // Write next to the target and swap in, so a crash mid-write never
+    // leaves a truncated snapshot behind.
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "[Snapshot] Cannot open " << tmpPath << " for writing\n";
+            return false;
+        }
+        out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        if (!out) {
+            std::cerr << "[Snapshot] Write failed: " << tmpPath << "\n";
+            return false;
+        }
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(path.c_str());
+        if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            std::cerr << "[Snapshot] Cannot replace " << path << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Graph::loadSnapshot(const std::string& path)
+{
+    auto startTime = std::chrono::steady_clock::now();
+
+    MappedFile file(path);
+    if (!file.data) {
+        std::cerr << "[Snapshot] Cannot map " << path << "\n";
+        return false;
+    }
+    if (file.size < sizeof(SnapshotHeader)) {
+        std::cerr << "[Snapshot] File too small: " << path << "\n";
+        return false;
+    }
+
+    SnapshotHeader h;
+    std::memcpy(&h, file.data, sizeof(h));
+    if (std::memcmp(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic)) != 0 ||
+        h.version != SNAPSHOT_VERSION || h.fileSize != file.size) {
+        std::cerr << "[Snapshot] Unrecognized or truncated snapshot: " << path << "\n";
+        return false;
+    }
+
+    const uint32_t A = h.assetCount;
+    const uint32_t X = h.exchangeCount;
+    const uint32_t V = h.nodeCount;
+    const uint32_t E = h.edgeCount;
+    const uint64_t S = static_cast<uint64_t>(A) + X + E + 1;
+
+    // The mapping is page aligned, so an offset that is a multiple of the
+    // element size makes the cast below a properly aligned array.
+    auto fits = [&](uint64_t offset, uint64_t count, uint64_t elem) {
+        return offset % elem == 0 && offset <= file.size && count * elem <= file.size - offset;
+    };
+    if (!fits(h.stringOffsetsAt, S, sizeof(uint32_t)) ||
+        !fits(h.stringBlobAt, h.stringBytes, 1) ||
+        !fits(h.nodeAssetAt, V, sizeof(int32_t)) ||
+        !fits(h.nodeExchangeAt, V, sizeof(int32_t)) ||
+        !fits(h.edgeSrcAt, E, sizeof(int32_t)) ||
+        !fits(h.edgeDstAt, E, sizeof(int32_t)) ||
+        !fits(h.edgeExchangeAt, E, sizeof(int32_t)) ||
+        !fits(h.edgePriceAt, E, sizeof(double))) {
+        std::cerr << "[Snapshot] Corrupt section table: " << path << "\n";
+        return false;
+    }
+
+    const uint32_t* stringOffsets = reinterpret_cast<const uint32_t*>(file.data + h.stringOffsetsAt);
+    const char* blob = file.data + h.stringBlobAt;
+    const int32_t* snapNodeAsset = reinterpret_cast<const int32_t*>(file.data + h.nodeAssetAt);
+    const int32_t* snapNodeExchange = reinterpret_cast<const int32_t*>(file.data + h.nodeExchangeAt);
+    const int32_t* snapSrc = reinterpret_cast<const int32_t*>(file.data + h.edgeSrcAt);
+    const int32_t* snapDst = reinterpret_cast<const int32_t*>(file.data + h.edgeDstAt);
+    const int32_t* snapExchange = reinterpret_cast<const int32_t*>(file.data + h.edgeExchangeAt);
+    const double* snapPrice = reinterpret_cast<const double*>(file.data + h.edgePriceAt);
+
+    for (uint64_t i = 0; i + 1 < S; ++i) {
+        if (stringOffsets[i] > stringOffsets[i + 1] || stringOffsets[i + 1] > h.stringBytes) {
+            std::cerr << "[Snapshot] Corrupt string table: " << path << "\n";
+            return false;
+        }
+    }
+    for (uint32_t n = 0; n < V; ++n) {
+        if (snapNodeAsset[n] < 0 || snapNodeAsset[n] >= (int32_t)A ||
+            snapNodeExchange[n] < NO_EXCHANGE || snapNodeExchange[n] >= (int32_t)X) {
+            std::cerr << "[Snapshot] Corrupt node table: " << path << "\n";
+            return false;
+        }
+    }
+    for (uint32_t e = 0; e < E; ++e) {
+        if (snapSrc[e] < 0 || snapSrc[e] >= (int32_t)V ||
+            snapDst[e] < 0 || snapDst[e] >= (int32_t)V || snapSrc[e] == snapDst[e] ||
+            snapExchange[e] < NO_EXCHANGE || snapExchange[e] >= (int32_t)X ||
+            !std::isfinite(-std::log(snapPrice[e]))) {
+            std::cerr << "[Snapshot] Corrupt edge table: " << path << "\n";
+            return false;
+        }
+    }
+
+    auto stringAt = [&](uint64_t i) {
+        return std::string(blob + stringOffsets[i], stringOffsets[i + 1] - stringOffsets[i]);
+    };
+
+    // Interning must give every asset, exchange and node its snapshot index
+    // (assetNames.size() == A and so on once loaded), so no name or (asset,
+    // exchange) pair may repeat.
+    {
+        std::unordered_set<std::string> names;
+        for (uint32_t a = 0; a < A; ++a) names.insert(stringAt(a));
+        const bool assetsUnique = names.size() == A;
+        names.clear();
+        for (uint32_t x = 0; x < X; ++x) names.insert(stringAt(A + x));
+        const bool exchangesUnique = names.size() == X;
+        std::unordered_set<uint64_t> keys;
+        for (uint32_t n = 0; n < V; ++n) keys.insert(nodeKey(snapNodeAsset[n], snapNodeExchange[n]));
+        if (!assetsUnique || !exchangesUnique || keys.size() != V) {
+            std::cerr << "[Snapshot] Duplicate asset, exchange or node: " << path << "\n";
+            return false;
+        }
+    }
+
+    // A Cross record between two nodes of one asset must join a new node to
+    // the group headed by the base of that asset's first such record.
+    int32_t cross = NO_EXCHANGE;
+    for (uint32_t x = 0; x < X; ++x) if (stringAt(A + x) == "Cross") cross = static_cast<int32_t>(x);
+    if (cross != NO_EXCHANGE) {
+        std::vector<int32_t> head(A, -1);
+        std::vector<uint8_t> joined(V, 0);
+        for (uint32_t e = 0; e < E; ++e) {
+            const int32_t u = snapSrc[e];
+            const int32_t v = snapDst[e];
+            if (snapExchange[e] != cross || u == v || snapNodeAsset[u] != snapNodeAsset[v]) continue;
+            int32_t& hub = head[snapNodeAsset[u]];
+            if (hub < 0) { hub = u; joined[u] = 1; }
+            if (u != hub || joined[v]) {
+                std::cerr << "[Snapshot] Corrupt bridge table: " << path << "\n";
+                return false;
+            }
+            joined[v] = 1;
+        }
+    }
+
+    // Everything validated: replace the current graph.
+    resetGraph();
+
+    for (uint32_t a = 0; a < A; ++a) internAsset(stringAt(a));
+    for (uint32_t x = 0; x < X; ++x) internExchange(stringAt(A + x));
+    for (uint32_t n = 0; n < V; ++n) addNode(snapNodeAsset[n], snapNodeExchange[n]);
+
+    for (uint32_t e = 0; e < E; ++e)
+        insertEdge(snapSrc[e], snapDst[e], -std::log(snapPrice[e]), snapPrice[e], snapExchange[e], stringAt(A + X + e));
+    superSourceId = findNode("SUPER_SOURCE", NO_EXCHANGE);
+
+    warmStarted = true;
+
+    auto ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "[Snapshot] Loaded " << V << " nodes, " << E << " markets from "
+              << path << " in " << std::fixed << std::setprecision(2) << ms << " ms\n";
+    return true;
+}
+
+void Graph::resetGraph()
+{
+    assetIds.clear();
+    assetNames.clear();
+    exchangeIds.clear();
+    exchangeNames.clear();
+    crossExchangeId = -1;
+    nodeIds.clear();
+    nodeAsset.clear();
+    nodeExchange.clear();
+    nodeNames.clear();
+    edges = EdgeStore();
+    edgeIndex.clear();
+    bridgeMembers.clear();
+    priceHandles.clear();
+    superSourceId = -1;
+    changedEdges.clear();
+    edgeChanged.clear();
+    incr = IncrementalState();
+    howard = HowardState();
+    // Edge ids are reassigned, so nothing the matrix last saw carries over.
+    apsp.topology = UINT64_MAX;
+    apsp.weight.clear();
+    apsp.held.clear();
+    apsp.heldEdges.clear();
+    shortCycles.topology = UINT64_MAX;
+    sccVersion = UINT64_MAX;
+    certPotential.clear();
+    certHolds = false;
+    priceJournalStart += priceJournal.size();
+    priceJournal.clear();
+    ++topologyVersion;
+}
+
+void Graph::exportImage(GraphImage& img) const
+{
+    const bool topologyMoved = img.topologyVersion != topologyVersion;
+    if (topologyMoved) {
+        img.assetNames = assetNames;
+        img.exchangeNames = exchangeNames;
+        img.nodeAsset.assign(nodeAsset.begin(), nodeAsset.end());
+        img.nodeExchange.assign(nodeExchange.begin(), nodeExchange.end());
+        img.marketBase = edges.base;
+        img.marketQuote = edges.quote;
+        img.marketExchange = edges.marketExchange;
+        img.marketSymbol = edges.marketSymbol;
+        img.topologyVersion = topologyVersion;
+    }
+    img.warmStarted = warmStarted;
+
+    // The image already holds every price up to its journal position, so
+    // only the markets journaled since then are copied.
+    const uint64_t journalEnd = priceJournalStart + priceJournal.size();
+    if (topologyMoved || img.priceSeq < priceJournalStart) {
+        img.marketWeight.assign(edges.marketWeight.begin(), edges.marketWeight.end());
+        img.marketPrice.assign(edges.marketPrice.begin(), edges.marketPrice.end());
+    } else {
+        for (size_t i = static_cast<size_t>(img.priceSeq - priceJournalStart); i < priceJournal.size(); ++i) {
+            const int m = priceJournal[i];
+            img.marketWeight[m] = edges.marketWeight[m];
+            img.marketPrice[m] = edges.marketPrice[m];
+        }
+    }
+    img.priceSeq = journalEnd;
+}
+
+void Graph::importImage(const GraphImage& img)
+{
+    warmStarted = warmStarted || img.warmStarted;
+
+    if (img.topologyVersion != importedTopology) {
+        resetGraph();
+
+        for (const auto& a : img.assetNames) internAsset(a);
+        for (const auto& x : img.exchangeNames) internExchange(x);
+        for (size_t n = 0; n < img.nodeAsset.size(); ++n)
+            addNode(img.nodeAsset[n], img.nodeExchange[n]);
+        for (size_t m = 0; m < img.marketBase.size(); ++m)
+            insertEdge(img.marketBase[m], img.marketQuote[m], img.marketWeight[m],
+                       img.marketPrice[m], img.marketExchange[m], img.marketSymbol[m]);
+
+        superSourceId = findNode("SUPER_SOURCE", NO_EXCHANGE);
+        importedTopology = img.topologyVersion;
+        return;
+    }
+
+    // Same topology: only weights moved.
+    for (size_t m = 0; m < img.marketBase.size(); ++m) {
+        if (edges.marketWeight[m] != img.marketWeight[m] || edges.marketPrice[m] != img.marketPrice[m])
+            setEdgeWeight(edges.firstEdge[m], img.marketWeight[m], img.marketPrice[m]);
+    }
+}
+
+void GraphPublisher::publish(const Graph& writer)
+{
+    writer.exportImage(images[back]);
+    uint8_t prev = shared.exchange(static_cast<uint8_t>(back | FRESH), std::memory_order_acq_rel);
+    back = prev & INDEX_MASK;
+}
+
+const GraphImage* GraphPublisher::acquire()
+{
+    if (!(shared.load(std::memory_order_acquire) & FRESH)) return nullptr;
+    uint8_t prev = shared.exchange(front, std::memory_order_acq_rel);
+    front = prev & INDEX_MASK;
+    return &images[front];
+}
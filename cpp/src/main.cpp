@@ -1,33 +1,132 @@
 #include "SocketClient.hpp"
 #include "Graph.h"
 #include <iostream>
+#include <cstdlib>
 #include <limits>
 #include <thread>
 #include <filesystem>
 
-int main() {
+static constexpr int SNAPSHOT_INTERVAL_SECONDS = 5;
+static constexpr int IDLE_SPINS = 64;              // empty polls yielded before the detector sleeps
+static constexpr int IDLE_SLEEP_MICROSECONDS = 200; // sleep per empty poll after that
+
+int main(int argc, char* argv[]) {
+    std::string snapshotPath;
+    bool threaded = false;
+    RelaxKernel kernel = RelaxKernel::BellmanFord;
+    int shortCycleLength = 4;
+    int maxHops = 10;
+    int topK = 10;
+    int detectionThreads = 1;
+    SimdLevel simd = detectSimdLevel();
+    bool contractBridges = false;
+    bool fixedPoint = false;
+    bool floatScreen = false;
+    int syntheticNodes = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--snapshot" && i + 1 < argc) {
+            snapshotPath = argv[++i];
+        } else if (arg == "--threaded") {
+            threaded = true;
+        } else if (arg == "--kernel" && i + 1 < argc && std::string(argv[i + 1]) == "bf") {
+            kernel = RelaxKernel::BellmanFord;
+            ++i;
+        } else if (arg == "--kernel" && i + 1 < argc && std::string(argv[i + 1]) == "queue") {
+            kernel = RelaxKernel::Queue;
+            ++i;
+        } else if (arg == "--cycle-len" && i + 1 < argc && std::atoi(argv[i + 1]) >= 3) {
+            shortCycleLength = std::atoi(argv[++i]);
+        } else if (arg == "--max-hops" && i + 1 < argc && std::atoi(argv[i + 1]) >= 3) {
+            maxHops = std::atoi(argv[++i]);
+        } else if (arg == "--top-k" && i + 1 < argc && std::atoi(argv[i + 1]) >= 1) {
+            topK = std::atoi(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc && std::atoi(argv[i + 1]) >= 1) {
+            detectionThreads = std::atoi(argv[++i]);
+        } else if (arg == "--simd" && i + 1 < argc && std::string(argv[i + 1]) == "scalar") {
+            simd = SimdLevel::Scalar;
+            ++i;
+        } else if (arg == "--simd" && i + 1 < argc && std::string(argv[i + 1]) == "avx2") {
+            simd = SimdLevel::Avx2;
+            ++i;
+        } else if (arg == "--simd" && i + 1 < argc && std::string(argv[i + 1]) == "avx512") {
+            simd = SimdLevel::Avx512;
+            ++i;
+        } else if (arg == "--contract-bridges") {
+            contractBridges = true;
+        } else if (arg == "--fixed-point") {
+            fixedPoint = true;
+        } else if (arg == "--float-screen") {
+            floatScreen = true;
+        } else if (arg == "--bench-synthetic" && i + 1 < argc && std::atoi(argv[i + 1]) >= 10) {
+            syntheticNodes = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n"
+                      << "Usage: arbitrage_detector [--snapshot <file>] [--threaded] [--kernel bf|queue] [--cycle-len <n>] [--max-hops <n>]\n"
+                      << "                          [--top-k <n>] [--threads <n>] [--simd scalar|avx2|avx512] [--contract-bridges]\n"
+                      << "                          [--fixed-point] [--float-screen] [--bench-synthetic <max nodes>]\n";
+            return 1;
+        }
+    }
+
+    Graph g;
+    g.setRelaxKernel(kernel);
+    g.setShortCycleLength(shortCycleLength);
+    g.setMaxHops(maxHops);
+    g.setTopK(topK);
+    g.setDetectionThreads(detectionThreads);
+    g.setSimdLevel(simd);
+    g.setContractBridges(contractBridges);
+    g.setFixedPoint(fixedPoint);
+    g.setFloatScreen(floatScreen);
+    std::cout << "[SIMD] Bellman-Ford relaxation: " << simdLevelName(g.getSimdLevel()) << "\n";
+
+    if (syntheticNodes > 0) {
+        g.runSyntheticBenchmark(syntheticNodes);
+        return 0;
+    }
+
     std::cout << "=== Arbitrage Detection System ===\n";
     std::cout << "1. All sources\n";
     std::cout << "2. Single source\n";
     std::cout << "3. Benchmark (performance comparison)\n";
+    std::cout << "4. Incremental (repair around changed edges)\n";
+    std::cout << "5. Min-mean cycle (Howard policy iteration)\n";
+    std::cout << "6. Short-cycle index (re-sum cycles through changed edges)\n";
+    std::cout << "7. Hop-bounded (cycles of at most --max-hops edges)\n";
+    std::cout << "8. All-pairs (dynamic shortest-path matrix)\n";
+    std::cout << "9. Tropical (best cycle of each length up to --cycle-len)\n";
+    std::cout << "10. Top-K (most profitable cycles of at most --max-hops edges)\n";
     std::cout << "Choice: ";
     
     int mode = 0;
     while (true) {
         std::cin >> mode;
-        if (std::cin.fail() || (mode < 1 || mode > 3)) {
+        if (std::cin.fail() || (mode < 1 || mode > 10)) {
             std::cin.clear();
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-            std::cout << "Invalid choice. Enter 1, 2 or 3: ";
+            std::cout << "Invalid choice. Enter 1 to 10: ";
         } else break;
     }
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     
     Socket::Client client("127.0.0.1", 5001);
-    Graph g;
+    Graph writer;                          // ingest-side graph in threaded mode
+    Graph& ingestGraph = threaded ? writer : g;
+
+    if (!snapshotPath.empty()) {
+        if (std::filesystem::exists(snapshotPath))
+            ingestGraph.loadSnapshot(snapshotPath);
+        else
+            std::cout << "[Snapshot] " << snapshotPath << " not found, starting cold\n";
+    }
+    auto lastSnapshot = std::chrono::steady_clock::now();
     
-    if (mode == 1) {
-        std::cout << "\n[INFO] Selected mode: Classic\n";
+    if (mode == 1 || mode >= 4) {
+        static const char* const names[] = {"", "Classic", "", "", "Incremental",
+                                            "Min-mean cycle", "Short-cycle index", "Hop-bounded",
+                                            "All-pairs", "Tropical", "Top-K"};
+        std::cout << "\n[INFO] Selected mode: " << names[mode] << "\n";
         
         auto now = std::chrono::system_clock::now();
         auto timestamp = std::chrono::system_clock::to_time_t(now);
@@ -49,18 +148,80 @@ int main() {
     
     std::cout << "[INFO] Waiting for data from Python server...\n"
               << "--------------------------------------------\n";
-    
-    while (true) {
-        std::string msg = client.receiveMessage();
-        g.processMessage(msg);
-        
+
+    auto detect = [mode](Graph& graph) {
         if (mode == 1)
-            g.findArbitrage();
+            graph.findArbitrage();
         else if (mode == 2)
-            g.findArbitrageSuperSource();
+            graph.findArbitrageSuperSource();
+        else if (mode == 4)
+            graph.findArbitrageIncremental();
+        else if (mode == 5)
+            graph.findMinMeanCycle();
+        else if (mode == 6)
+            graph.findArbitrageShortCycles();
+        else if (mode == 7)
+            graph.findArbitrageHopBounded();
+        else if (mode == 8)
+            graph.findArbitrageAllPairs();
+        else if (mode == 9)
+            graph.findArbitrageTropical();
+        else if (mode == 10)
+            graph.findArbitrageTopK();
         else
-            g.runBenchmark();
+            graph.runBenchmark();
+    };
+
+    auto maybeSaveSnapshot = [&](const Graph& graph) {
+        if (snapshotPath.empty()) return;
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastSnapshot >= std::chrono::seconds(SNAPSHOT_INTERVAL_SECONDS)) {
+            graph.saveSnapshot(snapshotPath);
+            lastSnapshot = now;
+        }
+    };
+
+    if (!threaded) {
+        while (true) {
+            std::string msg = client.receiveMessage();
+            g.processMessage(msg);
+            detect(g);
+            maybeSaveSnapshot(g);
+        }
     }
-    
+
+    // Threaded pipeline: the ingest thread owns the writer graph and publishes
+    // an image after every tick; this thread imports the newest image into
+    // 'g' and scans it. Ticks that arrive during a scan are coalesced.
+    std::cout << "[INFO] Threaded pipeline: ingest and detection on separate threads\n";
+
+    GraphPublisher publisher;
+    std::thread ingest([&]() {
+        while (true) {
+            std::string msg = client.receiveMessage();
+            writer.processMessage(msg);
+            publisher.publish(writer);
+            maybeSaveSnapshot(writer);
+        }
+    });
+
+    int idlePolls = 0;
+    while (true) {
+        const GraphImage* image = publisher.acquire();
+        if (!image) {
+            // A burst of ticks is picked up after a yield; a quiet market
+            // then sleeps instead of pinning a core. publish() stays lock-free.
+            if (++idlePolls <= IDLE_SPINS)
+                std::this_thread::yield();
+            else
+                std::this_thread::sleep_for(std::chrono::microseconds(IDLE_SLEEP_MICROSECONDS));
+            continue;
+        }
+        idlePolls = 0;
+        g.importImage(*image);
+        detect(g);
+    }
+
+    ingest.join();
     return 0;
-}
\ No newline at end of file
+}
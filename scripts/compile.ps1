@@ -29,6 +29,9 @@ if (-not (Test-Path $BuildDir)) {
 # Deterministic list of source files
 $Sources = @(
     (Join-Path $SrcDir "Graph.cpp"),
+    (Join-Path $SrcDir "GraphParallel.cpp"),
+    (Join-Path $SrcDir "GraphSimd.cpp"),
+    (Join-Path $SrcDir "GraphSnapshot.cpp"),
     (Join-Path $SrcDir "SocketClient.cpp"),
     (Join-Path $SrcDir "main.cpp")
 )
@@ -45,7 +48,7 @@ foreach ($src in $Sources) {
 $Command = "g++ " + ($Sources -join " ") + `
     " -I`"" + $IncDir + "`"" + `
     " -o `"" + $Executable + "`"" + `
-    " -lws2_32 -mconsole"
+    " -pthread -lws2_32 -mconsole"
 
 Write-Host "Executing command:"
 Write-Host "    $Command"